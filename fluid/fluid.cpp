@@ -109,7 +109,7 @@ Fluid::~Fluid()
       {
       _state = FLUID_SYNTH_STOPPED;
       foreach(Voice* v, activeVoices)
-            delete v;
+            v->off();         // gives back its sample stream and moves it to freeVoices
       foreach(Voice* v, freeVoices)
             delete v;
       foreach(SFont* sf, sfonts)
@@ -401,6 +401,8 @@ void Fluid::process(unsigned len, float* out, float* effect1, float* effect2)
                   v->write(len, out, effect1, effect2);
             mutex.unlock();
             }
+      else
+            ++_xruns;
       }
 
 /*
@@ -603,6 +605,9 @@ QStringList Fluid::soundFonts() const
 //---------------------------------------------------------
 //   loadSoundFont
 //    return false on error
+//    The soundfonts are read without holding the mutex; it
+//    is only locked to exchange the soundfont list, so that
+//    process() is not blocked while the files are read.
 //---------------------------------------------------------
 
 bool Fluid::loadSoundFonts(const QStringList& sl)
@@ -612,17 +617,10 @@ bool Fluid::loadSoundFonts(const QStringList& sl)
             qDebug("Fluid:loadSoundFonts: already loaded");
             return true;
             }
-      mutex.lock();
-      foreach(Voice* v, activeVoices)
-            v->off();
-      foreach(Channel* c, channel)
-            c->reset();
-      foreach (SFont* sf, sfonts)
-            sfunload(sf->id());
       bool ok = true;
 
-
       QFileInfoList l = sfFiles();
+      QList<SFont*> nl;
 
       for (int i = sl.size() - 1; i >= 0; --i) {
             QString s = sl[i];
@@ -642,13 +640,28 @@ bool Fluid::loadSoundFonts(const QStringList& sl)
                   ok = false;
                   }
             else {
-                  if (sfload(path) == -1) {
+                  SFont* sf = sfread(path);
+                  if (sf)
+                        nl.append(sf);
+                  else {
                         qDebug("loading sf failed: <%s>", qPrintable(path));
                         ok = false;
                         }
                   }
             }
+
+      QList<SFont*> dl;
+      mutex.lock();
+      foreach(Voice* v, activeVoices)
+            v->off();
+      foreach(Channel* c, channel)
+            c->reset();
+      foreach (SFont* sf, sfonts)
+            dl.append(sfunload(sf->id()));
+      foreach (SFont* sf, nl)
+            sfload(sf);
       mutex.unlock();
+      qDeleteAll(dl);
       return ok;
       }
 
@@ -659,10 +672,13 @@ bool Fluid::loadSoundFonts(const QStringList& sl)
 
 bool Fluid::addSoundFont(const QString& s)
       {
+      SFont* sf = sfread(s);
+      if (!sf)
+            return false;
       mutex.lock();
-      bool rv = (sfload(s) == -1) ? false : true;
+      sfload(sf);
       mutex.unlock();
-      return rv;
+      return true;
       }
 
 //---------------------------------------------------------
@@ -676,34 +692,45 @@ bool Fluid::removeSoundFont(const QString& s)
       foreach(Voice* v, activeVoices)
             v->off();
       SFont* sf = get_sfont_by_name(s);
-      sfunload(sf->id());
+      if (sf)
+            sf = sfunload(sf->id());
       mutex.unlock();
+      delete sf;
       return true;
       }
 
 //---------------------------------------------------------
-//   sfload
+//   sfread
+//    read a soundfont; does not touch the synthesizer
+//    state and can be called without holding the mutex
 //---------------------------------------------------------
 
-int Fluid::sfload(const QString& filename)
+SFont* Fluid::sfread(const QString& filename)
       {
       if (filename.isEmpty())
-            return -1;
+            return 0;
 
       SFont* sf = new SFont(this);
       try {
             if (!sf->read(filename)) {
                   delete sf;
-                  sf = 0;
-                  return -1;
+                  return 0;
                   }
             }
       catch(...) {
             delete sf;
-            sf = 0;
-            return -1;
+            return 0;
             }
+      return sf;
+      }
 
+//---------------------------------------------------------
+//   sfload
+//    add a soundfont read by sfread()
+//---------------------------------------------------------
+
+int Fluid::sfload(SFont* sf)
+      {
       sf->setId(++sfont_id);
 
       /* insert the sfont as the first one on the list */
@@ -717,22 +744,22 @@ int Fluid::sfload(const QString& filename)
 
 //---------------------------------------------------------
 //   sfunload
+//    remove the soundfont from the list; the caller
+//    deletes it after releasing the mutex
 //---------------------------------------------------------
 
-bool Fluid::sfunload(int id)
+SFont* Fluid::sfunload(int id)
       {
       SFont* sf = get_sfont_by_id(id);
 
       if (!sf) {
             qDebug("No SoundFont with id = %d", id);
-            return false;
+            return 0;
             }
 
       sfonts.removeAll(sf);   // remove the SoundFont from the list
       updatePatchList();
-
-      delete sf;
-      return true;
+      return sf;
       }
 
 //---------------------------------------------------------
@@ -323,8 +323,9 @@ class Fluid : public Synthesizer {
       SFont* get_sfont_by_name(const QString& name);
       SFont* get_sfont_by_id(int id);
       SFont* get_sfont(int idx) const     { return sfonts[idx];   }
-      bool sfunload(int id);
-      int sfload(const QString& filename);
+      SFont* sfunload(int id);
+      SFont* sfread(const QString& filename);
+      int sfload(SFont*);
 
    public:
       Fluid();
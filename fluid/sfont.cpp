@@ -28,6 +28,7 @@
 // #define DEBUG_SFONT
 
 #include "libmscore/xml.h"
+#include "synthesizer/samplestream.h"
 
 static bool debugMode = false;
 
@@ -52,6 +53,7 @@ SFont::SFont(Fluid* f)
       synth       = f;
       samplepos   = 0;
       samplesize  = 0;
+      mapData     = 0;
       _bankOffset = 0;
       }
 
@@ -586,6 +588,10 @@ Sample::Sample(SFont* s)
       pitchadj    = 0;
       sampletype  = 0;
       data        = 0;
+      _mapped     = false;
+      _bytes      = 0;
+      _source     = 0;
+      _resident   = 0;
       amplitude_that_reaches_noise_floor_is_valid = false;
       amplitude_that_reaches_noise_floor = 0.0;
       }
@@ -596,7 +602,17 @@ Sample::Sample(SFont* s)
 
 Sample::~Sample()
       {
-      delete[] data;
+      if (_mapped) {
+            if (_source) {
+                  Ms::SampleStreamer::instance()->detach(_source);
+                  delete _source;
+                  }
+            Ms::SampleMemory::unstream(_bytes);
+            }
+      else {
+            Ms::SampleMemory::unload(_bytes);
+            delete[] data;
+            }
       }
 
 //---------------------------------------------------------
@@ -630,10 +646,36 @@ void Sample::load()
                   }
             decompressOggVorbis(p, size);
             delete[] p;
+            if (data) {
+                  _bytes = qint64(end + 1) * sizeof(short);
+                  Ms::SampleMemory::load(_bytes);
+                  }
 #endif
             }
+      else if (QSysInfo::ByteOrder == QSysInfo::LittleEndian
+         && !Ms::SampleMemory::fits(size * sizeof(short)) && sf->mapSampleData()) {
+            // over the memory budget: use the sample data in place;
+            // the first preload ms are paged in now, the voices
+            // page in the rest ahead of playing it
+            data      = sf->mapSampleData() + start;
+            _mapped   = true;
+            _bytes    = size * sizeof(short);
+            _resident = qMin(unsigned(Ms::SampleMemory::preload()) * samplerate / 1000, size);
+            Ms::SampleMemory::stream(_bytes);
+            Ms::SampleMemory::prefetch(data, _resident * sizeof(short));
+            end       -= (start + 1);       // marks last sample, contrary to SF spec.
+            loopstart -= start;
+            loopend   -= start;
+            start      = 0;
+            _source           = new Ms::StreamSource;
+            _source->data     = data;
+            _source->channels = 1;
+            _source->frames   = size;
+            }
       else {
             data = new short[size];
+            _bytes = size * sizeof(short);
+            Ms::SampleMemory::load(_bytes);
             size *= sizeof(short);
 
             if (fd.read((char*)data, size) != size)
@@ -656,7 +698,25 @@ void Sample::load()
             loopend   -= start;
             start      = 0;
             }
-      optimize();
+      // the loop scan would page in mapped data
+      if (!_mapped)
+            optimize();
+      }
+
+//---------------------------------------------------------
+//   mapSampleData
+//    map the sample chunk of the soundfont file; the
+//    mapping is kept until the soundfont is deleted
+//---------------------------------------------------------
+
+short* SFont::mapSampleData()
+      {
+      if (!mapData && !mapFile.isOpen() && samplesize) {
+            mapFile.setFileName(f.fileName());
+            if (mapFile.open(QIODevice::ReadOnly))
+                  mapData = mapFile.map(samplepos, samplesize);
+            }
+      return reinterpret_cast<short*>(mapData);
       }
 
 //---------------------------------------------------------
@@ -26,6 +26,10 @@
 #include "config.h"
 #include "fluid.h"
 
+namespace Ms {
+struct StreamSource;
+}
+
 namespace FluidS {
 
 class Preset;
@@ -54,6 +58,8 @@ class SFont {
       QFile f;
       unsigned samplepos;           // the position in the file at which the sample data starts
       unsigned samplesize;          // the size of the sample data
+      QFile mapFile;                // keeps the sample data mapped
+      uchar* mapData;               // mapped sample data or 0
 
       QList<Instrument*> instruments;
       QList<Preset*> presets;
@@ -109,6 +115,7 @@ class SFont {
       bool read(const QString& file);
 
       int load_sampledata();
+      short* mapSampleData();
       unsigned int samplePos() const            { return samplepos;  }
       int id() const                            { return _id; }
       void setId(int i)                         { _id = i;    }
@@ -128,6 +135,10 @@ class SFont {
 
 class Sample {
       bool _valid;
+      bool _mapped;                 // data points into SFont::mapSampleData()
+      qint64 _bytes;                // size of data
+      Ms::StreamSource* _source;    // voices page in mapped data through it
+      unsigned int _resident;       // number of mapped frames paged in by load()
 
    public:
       SFont* sf;
@@ -157,6 +168,8 @@ class Sample {
       void optimize();
       void load();
       bool valid() const    { return _valid; }
+      const Ms::StreamSource* source() const { return _source; }
+      unsigned int resident() const          { return _resident; }
       void setValid(bool v) { _valid = v; }
 #ifdef SOUNDFONT3
       bool decompressOggVorbis(char* p, int size);
@@ -23,6 +23,7 @@
 #include "sfont.h"
 #include "gen.h"
 #include "voice.h"
+#include "synthesizer/samplestream.h"
 
 namespace FluidS {
 
@@ -57,6 +58,7 @@ namespace FluidS {
 Voice::Voice(Fluid* f)
       {
       _fluid  = f;
+      _stream = 0;
       status  = FLUID_VOICE_OFF;
       chan    = NO_CHANNEL;
       key     = 0;
@@ -522,6 +524,20 @@ void Voice::write(unsigned n, float* out, float* reverb, float* chorus)
          * Depending on the position in the loop and the loop size, this
          * may require several runs. */
 
+      /* the sample data read by this run must be paged in; once
+       * the voice has looped, the loop has been paged in, too.
+       * The stream starts at the beginning of the sample and is
+       * moved to the start offset by the first consumed() */
+      if (_stream && !has_looped) {
+            _stream->consumed(qMax(phase.index() - 1, 0));
+            qint64 need = qMin(qint64(phase.index() + phase_incr * n) + 4, qint64(end) + 1);
+            if (_stream->available() < need) {
+                  Ms::SampleMemory::underrun();
+                  ticks += n;
+                  return;
+                  }
+            }
+
       float l_dsp_buf[n];
       dsp_buf = l_dsp_buf;
       unsigned count;
@@ -689,6 +705,15 @@ void Voice::voice_start()
        */
       check_sample_sanity_flag = FLUID_SAMPLESANITY_STARTUP;
 
+      if (_stream)
+            _stream->stop();
+      _stream = 0;
+      if (sample->source()) {
+            _stream = Ms::SampleStreamer::instance()->acquire();
+            if (_stream)
+                  _stream->start(sample->source(), 0, sample->resident());
+            }
+
       status = FLUID_VOICE_ON;
       }
 
@@ -1342,6 +1367,10 @@ void Voice::off()
       modenv_section = FLUID_VOICE_ENVFINISHED;
       modenv_count   = 0;
       status         = FLUID_VOICE_OFF;
+      if (_stream) {
+            _stream->stop();
+            _stream = 0;
+            }
       _fluid->freeVoice(this);
       }
 
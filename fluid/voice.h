@@ -24,6 +24,10 @@
 #include "fluid.h"
 #include "gen.h"
 
+namespace Ms {
+class SampleStream;
+}
+
 namespace FluidS {
 
 #define NO_CHANNEL             0xff
@@ -69,6 +73,7 @@ class Voice
 
       Fluid* _fluid;
       double _noteTuning;             // +/- in midicent
+      Ms::SampleStream* _stream;      // pages in mapped sample data
 
       void effects(int count, float* out, float* effect1, float* effect2);
 
@@ -641,7 +641,7 @@ void Chord::createLedgerLines(int track, vector<LedgerLineData>& vecLines, bool
       {
       qreal _spatium = spatium();
       for (auto lld : vecLines) {
-            LedgerLine* h = new LedgerLine(score());
+            LedgerLine* h = score()->ledgerLinePool().take();
             h->setParent(this);
             h->setTrack(track);
             h->setVisible(lld.visible && visible);
@@ -652,6 +652,22 @@ void Chord::createLedgerLines(int track, vector<LedgerLineData>& vecLines, bool
             }
       }
 
+//---------------------------------------------------------
+//   recycleLedgerLines
+//    give the ledger lines of the last layout back to the
+//    pool of the score
+//---------------------------------------------------------
+
+void Chord::recycleLedgerLines()
+      {
+      ElementPool<LedgerLine>& pool = score()->ledgerLinePool();
+      while (_ledgerLines) {
+            LedgerLine* l = _ledgerLines->next();
+            pool.give(_ledgerLines);
+            _ledgerLines = l;
+            }
+      }
+
 //---------------------------------------------------------
 //   addLedgerLines
 //---------------------------------------------------------
@@ -1738,11 +1754,7 @@ void Chord::layoutPitched()
       qreal graceMag = score()->styleD(StyleIdx::graceNoteMag);
       qreal chordX = (_noteType == NoteType::NORMAL) ? ipos().x() : 0.0;
 
-      while (_ledgerLines) {
-            LedgerLine* l = _ledgerLines->next();
-            delete _ledgerLines;
-            _ledgerLines = l;
-            }
+      recycleLedgerLines();
 
       qreal lll    = 0.0;         // space to leave at left of chord
       qreal rrr    = 0.0;         // space to leave at right of chord
@@ -2086,11 +2098,7 @@ void Chord::layoutTablature()
       for (Chord* c : _graceNotes)
             c->layoutTablature();
 
-      while (_ledgerLines) {
-            LedgerLine* l = _ledgerLines->next();
-            delete _ledgerLines;
-            _ledgerLines = l;
-            }
+      recycleLedgerLines();
 
       qreal lll         = 0.0;                  // space to leave at left of chord
       qreal rrr         = 0.0;                  // space to leave at right of chord
@@ -2177,7 +2185,7 @@ void Chord::layoutTablature()
             qreal extraLen    = 0;
             qreal llX         = stemX - (headWidth + extraLen) * 0.5;
             for (int i = 0; i < ledgerLines; i++) {
-                  LedgerLine* ldgLin = new LedgerLine(score());
+                  LedgerLine* ldgLin = score()->ledgerLinePool().take();
                   ldgLin->setParent(this);
                   ldgLin->setTrack(track());
                   ldgLin->setVisible(_visible);
@@ -101,6 +101,7 @@ class Chord : public ChordRest {
       virtual qreal centerX() const;
       void createLedgerLines(int track, std::vector<LedgerLineData> &vecLines, bool visible);
       void addLedgerLines(int move);
+      void recycleLedgerLines();
       void processSiblings(std::function<void(Element*)> func);
       void layoutPitched();
       void layoutTablature();
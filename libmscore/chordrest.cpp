@@ -235,13 +235,29 @@ void ChordRest::writeProperties(Xml& xml) const
                   int id = xml.spannerId(s);
                   xml.tagE(QString("Slur type=\"start\" id=\"%1\"").arg(id));
                   }
-            else if (s->endElement() == this) {
+            else if (s->endElement() == this || (xml.cutOff(s) && s->track2() == track() && lastBeforeCut(xml))) {
                   int id = xml.spannerId(s);
                   xml.tagE(QString("Slur type=\"stop\" id=\"%1\"").arg(id));
                   }
             }
       }
 
+//---------------------------------------------------------
+//   lastBeforeCut
+//    true if this is the last chord or rest of its track
+//    written by Score::write(..., end); slurs crossing the
+//    end stop here
+//---------------------------------------------------------
+
+bool ChordRest::lastBeforeCut(const Xml& xml) const
+      {
+      if (isGrace() || !segment())
+            return false;
+      Segment* s = segment()->next1();
+      ChordRest* cr = s ? s->nextChordRest(track()) : 0;
+      return !cr || cr->tick() >= xml.cutTick;
+      }
+
 //---------------------------------------------------------
 //   readProperties
 //---------------------------------------------------------
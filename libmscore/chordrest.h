@@ -167,6 +167,7 @@ class ChordRest : public DurationElement {
       bool isGraceBefore() const;
       bool isGraceAfter() const;
       void writeBeam(Xml& xml);
+      bool lastBeforeCut(const Xml&) const;
       Segment* nextSegmentAfterCR(Segment::Type types) const;
 
       virtual Element* nextElement() override;
@@ -122,10 +122,18 @@ void Score::endCmd(bool rollback)
             undo()->current()->unwind();
             }
 
+      // if all operations of this command are local to some
+      // measures, only relayout these
+      int stick = -1;
+      int etick = -1;
+      bool local = !rollback && undo()->current()->tickRange(&stick, &etick);
+      if (!local)
+            stick = -1;
+
       for (Score* s : scoreList()) {
             if (s->layoutAll()) {
                   s->_updateAll  = true;
-                  s->doLayout();
+                  s->doLayoutRange(stick, etick);
                   if (s != this)
                         s->deselectAll();
                   }
@@ -133,9 +141,18 @@ void Score::endCmd(bool rollback)
             if (is.noteEntryMode() && is.segment())
                   s->setPlayPos(is.segment()->tick());
             }
+
+      // remember which part of the playlist has to be rendered again
+      if (!rollback && !(local && stick == -1)) {
+            addPlaylistRange(stick, etick);
+            if (rootScore() != this)
+                  rootScore()->addPlaylistRange(stick, etick);
+            }
       if (_playlistDirty) {
             emit playlistChanged();
-            _playlistDirty = false;
+            _playlistDirty     = false;
+            _playlistStartTick = INT_MAX;
+            _playlistEndTick   = -1;
             }
 
       if (MScore::debugMode)
@@ -220,8 +237,11 @@ void Score::endUndoRedo()
             if (is.noteEntryMode() && is.segment())
                   score->setPlayPos(is.segment()->tick());
             if (_playlistDirty) {
+                  addPlaylistRange(-1, -1);
                   emit playlistChanged();
-                  _playlistDirty = false;
+                  _playlistDirty     = false;
+                  _playlistStartTick = INT_MAX;
+                  _playlistEndTick   = -1;
                   }
             }
       end();
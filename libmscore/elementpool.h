@@ -0,0 +1,82 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2015 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __ELEMENTPOOL_H__
+#define __ELEMENTPOOL_H__
+
+namespace Ms {
+
+class Score;
+
+//---------------------------------------------------------
+//   ElementPool
+//    free list of one element type, owned by a score.
+//    Elements which are generated by every layout are
+//    given back to the pool instead of being deleted and
+//    taken again by the next layout. The elements still in
+//    the pool are deleted with the score.
+//---------------------------------------------------------
+
+template <class T>
+class ElementPool {
+      Score* _score;
+      QVector<T*> _free;
+      int _created { 0 };
+      int _reused  { 0 };
+
+   public:
+      ElementPool(Score* s) : _score(s) {}
+      ElementPool(const ElementPool&) = delete;
+      ElementPool& operator=(const ElementPool&) = delete;
+      ~ElementPool()                { clear(); }
+
+      //---------------------------------------------------
+      //   take
+      //    return an element of the score; a recycled one
+      //    keeps the properties it had, the caller has to
+      //    set all properties layout depends on
+      //---------------------------------------------------
+
+      T* take() {
+            if (_free.isEmpty()) {
+                  ++_created;
+                  return new T(_score);
+                  }
+            ++_reused;
+            T* e = _free.takeLast();
+            e->setScore(_score);
+            return e;
+            }
+
+      //---------------------------------------------------
+      //   give
+      //    e must not be referenced anymore
+      //---------------------------------------------------
+
+      void give(T* e) {
+            e->setParent(0);
+            _free.append(e);
+            }
+
+      void clear() {
+            qDeleteAll(_free);
+            _free.clear();
+            }
+
+      int size() const              { return _free.size(); }
+      int created() const           { return _created; }
+      int reused() const            { return _reused;  }
+      };
+
+}     // namespace Ms
+#endif
+
@@ -0,0 +1,312 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2015 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include "glyphcache.h"
+
+namespace Ms {
+
+static const int PAGE_SIZE = 512;                           // pixels
+static const qint64 DEFAULT_BUDGET = 32 * 1024 * 1024;      // bytes
+
+//---------------------------------------------------------
+//   Page
+//    atlas of alpha masks, filled shelf by shelf
+//---------------------------------------------------------
+
+struct GlyphCache::Page {
+      struct Tint {                 // the page in one color
+            QImage image;
+            int glyphs { 0 };       // number of page glyphs already tinted
+            };
+
+      Zoom zoom;
+      int width;
+      int height;
+      QByteArray mask;              // width * height alpha values
+      QList<GlyphKey> keys;         // glyphs in insertion order
+      QList<QRect> rects;
+      int x     { 0 };              // packing position
+      int y     { 0 };
+      int shelf { 0 };              // height of the current shelf
+      QHash<QRgb, Tint> tints;
+      quint64 lastUse { 0 };
+
+      Page(Zoom z, int w, int h) : zoom(z), width(w), height(h), mask(w * h, 0) {}
+
+      qint64 bytes() const {
+            return mask.size() + qint64(tints.size()) * width * height * 4;
+            }
+
+      bool place(int w, int h, QRect* r) {
+            if (x + w > width) {
+                  y    += shelf;
+                  x     = 0;
+                  shelf = 0;
+                  }
+            if (x + w > width || y + h > height)
+                  return false;
+            *r = QRect(x, y, w, h);
+            x    += w + 1;
+            shelf = qMax(shelf, h + 1);
+            return true;
+            }
+      };
+
+//---------------------------------------------------------
+//   GlyphCache
+//---------------------------------------------------------
+
+GlyphCache::GlyphCache()
+      {
+      _budget = DEFAULT_BUDGET;
+      }
+
+//---------------------------------------------------------
+//   instance
+//    never deleted, score fonts remove their glyphs
+//    on destruction
+//---------------------------------------------------------
+
+GlyphCache* GlyphCache::instance()
+      {
+      static GlyphCache* cache = new GlyphCache;
+      return cache;
+      }
+
+//---------------------------------------------------------
+//   draw
+//    draw a cached glyph with its origin at pos; return
+//    false if the glyph is not in the cache. The draw
+//    right after insert() passes count = false.
+//---------------------------------------------------------
+
+bool GlyphCache::draw(QPainter* painter, const GlyphKey& key, const QPointF& pos, qreal worldScale, const QColor& color, bool count)
+      {
+      _mutex.lock();
+      auto i = _glyphs.constFind(key);
+      if (i == _glyphs.constEnd()) {
+            if (count)
+                  ++_stats.misses;
+            _mutex.unlock();
+            return false;
+            }
+      if (count)
+            ++_stats.hits;
+      Entry e = i.value();
+      if (!e.page) {
+            _mutex.unlock();
+            return true;
+            }
+      e.page->lastUse = ++_clock;
+      QImage image = tinted(e.page, color.rgba());    // shared copy, stays valid after eviction
+      evict(e.page);
+      _mutex.unlock();
+
+      QRectF target(pos + QPointF(e.offset) / worldScale, QSizeF(e.rect.size()) / worldScale);
+      painter->drawImage(target, image, e.rect);
+      return true;
+      }
+
+//---------------------------------------------------------
+//   tinted
+//    the page in color rgba, premultiplied
+//---------------------------------------------------------
+
+const QImage& GlyphCache::tinted(Page* p, QRgb rgba)
+      {
+      Page::Tint& t = p->tints[rgba];
+      if (t.image.isNull()) {
+            t.image = QImage(p->width, p->height, QImage::Format_ARGB32_Premultiplied);
+            t.image.fill(0);
+            _stats.bytes += qint64(p->width) * p->height * 4;
+            }
+      if (t.glyphs < p->rects.size()) {
+            QRgb lut[256];
+            int a = qAlpha(rgba);
+            for (int v = 0; v < 256; ++v) {
+                  int alpha = v * a / 255;
+                  lut[v] = qRgba(qRed(rgba) * alpha / 255, qGreen(rgba) * alpha / 255, qBlue(rgba) * alpha / 255, alpha);
+                  }
+            for (int g = t.glyphs; g < p->rects.size(); ++g) {
+                  const QRect& r = p->rects[g];
+                  for (int y = r.top(); y <= r.bottom(); ++y) {
+                        const uchar* src = reinterpret_cast<const uchar*>(p->mask.constData()) + y * p->width + r.left();
+                        QRgb* dst = reinterpret_cast<QRgb*>(t.image.scanLine(y)) + r.left();
+                        for (int x = 0; x < r.width(); ++x)
+                              *dst++ = lut[*src++];
+                        }
+                  }
+            t.glyphs = p->rects.size();
+            }
+      return t.image;
+      }
+
+//---------------------------------------------------------
+//   insert
+//    add a glyph rendered by FreeType as 8 bit gray
+//    bitmap; left and top are the bitmap position relative
+//    to the glyph origin
+//---------------------------------------------------------
+
+void GlyphCache::insert(const GlyphKey& key, const FT_Bitmap* bm, int left, int top)
+      {
+      QMutexLocker lock(&_mutex);
+      if (_glyphs.contains(key))
+            return;
+      Entry e;
+      e.page   = 0;
+      e.offset = QPoint(left, -top);
+      int w    = bm->width;
+      int h    = bm->rows;
+      if (w && h) {
+            e.page = place(key, w, h, &e.rect);
+            for (int y = 0; y < h; ++y) {
+                  const uchar* src = bm->buffer + bm->pitch * y;
+                  uchar* dst = reinterpret_cast<uchar*>(e.page->mask.data()) + (e.rect.top() + y) * e.page->width + e.rect.left();
+                  memcpy(dst, src, w);
+                  }
+            e.page->keys.append(key);
+            e.page->rects.append(e.rect);
+            }
+      _glyphs.insert(key, e);
+      if (e.page)
+            evict(e.page);
+      }
+
+//---------------------------------------------------------
+//   place
+//    find room for a glyph in the open page of its face
+//    and size, start a new page if it is full
+//---------------------------------------------------------
+
+GlyphCache::Page* GlyphCache::place(const GlyphKey& key, int w, int h, QRect* r)
+      {
+      Zoom zoom(quintptr(key.face), key.scale);
+      Page* p = _open.value(zoom);
+      if (!p || !p->place(w, h, r)) {
+            p = new Page(zoom, qMax(PAGE_SIZE, w), qMax(PAGE_SIZE, h));
+            p->place(w, h, r);
+            _pages.append(p);
+            _open[zoom] = p;
+            _stats.bytes += p->mask.size();
+            }
+      p->lastUse = ++_clock;
+      return p;
+      }
+
+//---------------------------------------------------------
+//   removePage
+//---------------------------------------------------------
+
+void GlyphCache::removePage(Page* p)
+      {
+      for (const GlyphKey& k : p->keys)
+            _glyphs.remove(k);
+      if (_open.value(p->zoom) == p)
+            _open.remove(p->zoom);
+      _stats.bytes -= p->bytes();
+      _pages.removeOne(p);
+      delete p;
+      }
+
+//---------------------------------------------------------
+//   evict
+//    drop least recently used pages other than keep until
+//    the cache fits into its budget
+//---------------------------------------------------------
+
+void GlyphCache::evict(Page* keep)
+      {
+      while (_stats.bytes > _budget && _pages.size() > 1) {
+            Page* lru = 0;
+            for (Page* p : _pages) {
+                  if (p != keep && (!lru || p->lastUse < lru->lastUse))
+                        lru = p;
+                  }
+            removePage(lru);
+            ++_stats.evictions;
+            }
+      }
+
+//---------------------------------------------------------
+//   remove
+//    all glyphs of face
+//---------------------------------------------------------
+
+void GlyphCache::remove(FT_Face face)
+      {
+      QMutexLocker lock(&_mutex);
+      for (Page* p : QList<Page*>(_pages)) {
+            if (p->zoom.first == quintptr(face))
+                  removePage(p);
+            }
+      for (auto i = _glyphs.begin(); i != _glyphs.end();) {
+            if (i.key().face == face)
+                  i = _glyphs.erase(i);
+            else
+                  ++i;
+            }
+      }
+
+//---------------------------------------------------------
+//   clear
+//---------------------------------------------------------
+
+void GlyphCache::clear()
+      {
+      QMutexLocker lock(&_mutex);
+      qDeleteAll(_pages);
+      _pages.clear();
+      _open.clear();
+      _glyphs.clear();
+      _stats.bytes = 0;
+      }
+
+//---------------------------------------------------------
+//   setBudget
+//---------------------------------------------------------
+
+void GlyphCache::setBudget(qint64 bytes)
+      {
+      QMutexLocker lock(&_mutex);
+      _budget = bytes;
+      evict(0);
+      }
+
+//---------------------------------------------------------
+//   stats
+//---------------------------------------------------------
+
+GlyphCache::Stats GlyphCache::stats() const
+      {
+      QMutexLocker lock(&_mutex);
+      Stats s  = _stats;
+      s.budget = _budget;
+      s.pages  = _pages.size();
+      s.glyphs = _glyphs.size();
+      return s;
+      }
+
+//---------------------------------------------------------
+//   resetStats
+//---------------------------------------------------------
+
+void GlyphCache::resetStats()
+      {
+      QMutexLocker lock(&_mutex);
+      _stats.hits      = 0;
+      _stats.misses    = 0;
+      _stats.evictions = 0;
+      }
+
+}
+
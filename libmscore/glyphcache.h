@@ -0,0 +1,111 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2015 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __GLYPHCACHE_H__
+#define __GLYPHCACHE_H__
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+class QPainter;
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   GlyphKey
+//    a glyph of a face rendered at one size
+//---------------------------------------------------------
+
+struct GlyphKey {
+      FT_Face face;
+      uint index;       // glyph index in face
+      int scale;        // 16.16 fixed point scale of the rendering
+
+      GlyphKey(FT_Face f, uint i, int s) : face(f), index(i), scale(s) {}
+      bool operator==(const GlyphKey& k) const {
+            return face == k.face && index == k.index && scale == k.scale;
+            }
+      };
+
+inline uint qHash(const GlyphKey& k, uint seed = 0)
+      {
+      uint h = seed;
+      h ^= qHash(quintptr(k.face)) + 0x9e3779b9 + (h << 6) + (h >> 2);
+      h ^= qHash(k.index)          + 0x9e3779b9 + (h << 6) + (h >> 2);
+      h ^= qHash(k.scale)          + 0x9e3779b9 + (h << 6) + (h >> 2);
+      return h;
+      }
+
+//---------------------------------------------------------
+//   GlyphCache
+//    Rendered glyphs are kept as alpha masks, packed into
+//    atlas pages shared by all glyphs of one face and size.
+//    A page is tinted once per color in use; only glyphs
+//    added since the last draw in that color are tinted
+//    again. When the memory budget is exceeded, the least
+//    recently used pages are dropped.
+//    All methods may be called from several threads, the
+//    glyphs are painted outside of the lock.
+//---------------------------------------------------------
+
+class GlyphCache {
+   public:
+      struct Stats {
+            quint64 hits      { 0 };
+            quint64 misses    { 0 };
+            quint64 evictions { 0 };      // pages dropped to stay in budget
+            qint64 bytes      { 0 };
+            qint64 budget     { 0 };
+            int pages         { 0 };
+            int glyphs        { 0 };
+            };
+
+   private:
+      struct Page;
+      struct Entry {
+            Page* page;       // 0 for empty glyphs
+            QRect rect;       // in page
+            QPoint offset;    // of the glyph origin in pixels
+            };
+      typedef QPair<quintptr, int> Zoom;
+
+      QHash<GlyphKey, Entry> _glyphs;
+      QList<Page*> _pages;
+      QHash<Zoom, Page*> _open;     // page receiving new glyphs of a face and size
+      qint64 _budget;
+      quint64 _clock { 0 };
+      Stats _stats;
+      mutable QMutex _mutex;
+
+      GlyphCache();
+      Page* place(const GlyphKey&, int w, int h, QRect*);
+      const QImage& tinted(Page*, QRgb);
+      void removePage(Page*);
+      void evict(Page* keep);
+
+   public:
+      static GlyphCache* instance();
+
+      bool draw(QPainter*, const GlyphKey&, const QPointF& pos, qreal worldScale, const QColor&, bool count = true);
+      void insert(const GlyphKey&, const FT_Bitmap*, int left, int top);
+      void remove(FT_Face);
+      void clear();
+
+      qint64 budget() const          { return _budget; }
+      void setBudget(qint64 bytes);
+      Stats stats() const;
+      void resetStats();
+      };
+
+}     // namespace Ms
+#endif
+
@@ -268,7 +268,7 @@ void Image::draw(QPainter* painter) const
                   if (score()->printing()) {
                         // use original image size for printing
                         painter->scale(s.width() / rasterDoc->width(), s.height() / rasterDoc->height());
-                        painter->drawPixmap(QPointF(0, 0), QPixmap::fromImage(*rasterDoc));
+                        painter->drawImage(QPointF(0, 0), *rasterDoc);     // pages may be printed outside of the gui thread
                         }
                   else {
                         QTransform t = painter->transform();
@@ -51,6 +51,7 @@
 #include "undo.h"
 #include "utils.h"
 #include "volta.h"
+#include "trace.h"
 
 namespace Ms {
 
@@ -68,6 +69,7 @@ namespace Ms {
 
 void Score::rebuildBspTree()
       {
+      TRACE_SCOPE("rebuildBspTree");
       for (Page* page : _pages)
             page->rebuildBspTree();
       }
@@ -80,6 +82,18 @@ void Score::rebuildBspTree()
 
 ChordRest* Score::searchNote(int tick, int track) const
       {
+      const QVector<ChordRest*>* index = _measures.chordRestIndex(track);
+      if (index) {
+            // first chord or rest at or after tick
+            auto i = std::lower_bound(index->begin(), index->end(), tick,
+               [](const ChordRest* cr, int t) { return cr->tick() < t; });
+            if (i == index->end())
+                  return 0;
+            if ((*i)->tick() == tick || i == index->begin())
+                  return *i;
+            return *(i - 1);
+            }
+
       ChordRest* ipe = 0;
       Segment::Type st = Segment::Type::ChordRest;
       for (Segment* segment = firstSegment(st); segment; segment = segment->next1(st)) {
@@ -1195,6 +1209,7 @@ void Score::beamGraceNotes(Chord* mainNote, bool after)
 
 void Score::layoutStage2()
       {
+      TRACE_SCOPE("layoutStage2");
       int tracks = nstaves() * VOICES;
       bool crossMeasure = styleB(StyleIdx::crossMeasureValues);
 
@@ -1369,18 +1384,72 @@ void Score::layoutStage2()
             }
       }
 
+//---------------------------------------------------------
+//   LayoutChordsJob
+//    layoutChords1() for one staff and a range of
+//    ChordRest segments
+//---------------------------------------------------------
+
+struct LayoutChordsJob {
+      Score* score;
+      Segment* first;
+      Segment* last;          // not included
+      int staffIdx;
+      };
+
+static const int LAYOUT_CHUNK_MEASURES = 16;
+
+static void layoutChordsJob(LayoutChordsJob& job)
+      {
+      for (Segment* s = job.first; s != job.last; s = s->next1(Segment::Type::ChordRest))
+            job.score->layoutChords1(s, job.staffIdx);
+      }
+
 //---------------------------------------------------------
 //   layoutStage3
+//    The chords of a segment are laid out independent of
+//    all other staves and segments, so the work is split
+//    into chunks of measures per staff and run on the
+//    global thread pool.
 //---------------------------------------------------------
 
-void Score::layoutStage3()
+void Score::layoutStage3(int stick, int etick)
       {
+      TRACE_SCOPE("layoutStage3");
       Segment::Type st = Segment::Type::ChordRest;
+      QList<QPair<Segment*, Segment*>> ranges;
+      Segment* s = firstSegment(st);
+      if (stick != -1) {
+            while (s && s->tick() < stick)
+                  s = s->next1(st);
+            }
+      while (s && (stick == -1 || s->tick() < etick)) {
+            Segment* fs = s;
+            Measure* m  = s->measure();
+            int n       = 0;
+            while (s && (stick == -1 || s->tick() < etick)) {
+                  if (s->measure() != m) {
+                        m = s->measure();
+                        if (++n == LAYOUT_CHUNK_MEASURES)
+                              break;
+                        }
+                  s = s->next1(st);
+                  }
+            ranges.append(QPair<Segment*, Segment*>(fs, s));
+            }
+
+      QList<LayoutChordsJob> jobs;
       for (int staffIdx = 0; staffIdx < nstaves(); ++staffIdx) {
             if (!staff(staffIdx)->show())
                   continue;
-            for (Segment* segment = firstSegment(st); segment; segment = segment->next1(st))
-                  layoutChords1(segment, staffIdx);
+            for (const auto& r : ranges)
+                  jobs.append({ this, r.first, r.second, staffIdx });
+            }
+      if (jobs.size() > 1 && MScore::parallelLayout)
+            QtConcurrent::blockingMap(jobs, layoutChordsJob);
+      else {
+            for (LayoutChordsJob& job : jobs)
+                  layoutChordsJob(job);
             }
       }
 
@@ -1393,6 +1462,23 @@ void Score::layoutStage3()
 
 void Score::doLayout()
       {
+      doLayoutRange(-1, -1);
+      }
+
+//---------------------------------------------------------
+//   doLayoutRange
+//    Relayout after an edit which only touched the measures
+//    in the tick range stick - etick. The measure stages
+//    run only for these measures and their immediate
+//    neighbours (for ties, beams and accidentals across
+//    barlines); all other measures keep their cached
+//    minimum width, so system and page layout are cheap.
+//    A stick of -1 lays out the whole score.
+//---------------------------------------------------------
+
+void Score::doLayoutRange(int stick, int etick)
+      {
+      TRACE_SCOPE("doLayout");
 // printf("doLayout %p cmd %d undo empty %d\n", this, undo()->active(), undo()->isEmpty());
 
       if (!undo()->active() && !undo()->isEmpty() && !undoRedo()) {
@@ -1419,6 +1505,11 @@ void Score::doLayout()
       _scoreFont = ScoreFont::fontFactory(_style.value(StyleIdx::MusicalSymbolFont).toString());
       _noteHeadWidth = _scoreFont->width(SymId::noteheadBlack, spatium() / (MScore::DPI * SPATIUM20));
 
+      // changed tick positions or multi measure rests can
+      // affect every measure
+      if ((layoutFlags & LayoutFlag::FIX_TICKS) || styleB(StyleIdx::createMultiMeasureRests))
+            stick = -1;
+
       if (layoutFlags & LayoutFlag::FIX_TICKS)
             fixTicks();
       if (layoutFlags & LayoutFlag::FIX_PITCH_VELO)
@@ -1427,8 +1518,11 @@ void Score::doLayout()
             createPlayEvents();
       layoutFlags = 0;
 
+      TRACE_BEGIN(stage1, "layoutStage1");
       int measureNo = 0;
       int nstaves = _staves.size();
+      int lstick = -1;        // range of measures actually laid out
+      int letick = -1;
       for (MeasureBase* m = first(); m; m = m->next()) {      // set layout break
             m->setPageBreak(false);
             m->setLineBreak(false);
@@ -1456,17 +1550,26 @@ void Score::doLayout()
                   measure->setNo(measureNo);
                   if (!measure->irregular())      // dont count measure
                         ++measureNo;
-                  measure->layoutStage1();
+                  if (stick == -1 || (measure->endTick() >= stick && measure->tick() <= etick)) {
+                        if (lstick == -1)
+                              lstick = measure->tick();
+                        letick = measure->endTick();
+                        measure->layoutStage1();
+                        }
                   }
             if (m->sectionBreak() && m->sectionBreak()->startWithMeasureOne())
                   measureNo = 0;
             }
 
+      TRACE_END(stage1);
+
       if (styleB(StyleIdx::createMultiMeasureRests))
             createMMRests();
 
       layoutStage2();   // beam notes, finally decide if chord is up/down
-      layoutStage3();   // compute note head horizontal positions
+      layoutStage3(stick == -1 ? -1 : lstick, letick);   // compute note head horizontal positions
+      _layoutStartTick = stick == -1 ? -1 : lstick;
+      _layoutEndTick   = stick == -1 ? -1 : letick;
 
       if (layoutMode() == LayoutMode::LINE)
             layoutLinear();
@@ -1477,6 +1580,7 @@ void Score::doLayout()
       //   place Spanner & beams
       //---------------------------------------------------
 
+      TRACE_BEGIN(spanner, "layoutSpanner");
       int tracks = nstaves * VOICES;
       for (int track = 0; track < tracks; ++track) {
             for (Segment* segment = firstSegmentMM(); segment; segment = segment->next1MM()) {
@@ -1549,6 +1653,7 @@ void Score::doLayout()
             }
       for (Spanner* s : _unmanagedSpanner)
             s->layout();
+      TRACE_END(spanner);
 
       if (layoutMode() != LayoutMode::LINE) {
             layoutSystems2();
@@ -1858,6 +1963,7 @@ static bool breakMultiMeasureRest(Measure* m)
 
 void Score::createMMRests()
       {
+      TRACE_SCOPE("createMMRests");
       //
       //  create mm rest measures
       //
@@ -3094,6 +3200,7 @@ QList<System*> Score::layoutSystemRow(qreal rowWidth, bool isFirstSystem, bool u
 
 void Score::layoutSystems()
       {
+      TRACE_SCOPE("layoutSystems");
       curMeasure              = _showVBox ? firstMM() : firstMeasureMM();
       curSystem               = 0;
       bool firstSystem        = true;
@@ -3148,6 +3255,7 @@ void Score::layoutSystems()
 
 void Score::layoutSystems2()
       {
+      TRACE_SCOPE("layoutSystems2");
       int n = _systems.size();
       for (int i = 0; i < n; ++i) {
             System* system = _systems.at(i);
@@ -3163,6 +3271,7 @@ void Score::layoutSystems2()
 
 void Score::layoutLinear()
       {
+      TRACE_SCOPE("layoutLinear");
       curMeasure     = first();
       curSystem      = 0;
       System* system = getNextSystem(true, false);
@@ -3375,6 +3484,7 @@ struct PageContext {
 
 void Score::layoutPages()
       {
+      TRACE_SCOPE("layoutPages");
       const qreal _spatium            = spatium();
       const qreal slb                 = styleS(StyleIdx::staffLowerBorder).val()    * _spatium;
       const qreal sub                 = styleS(StyleIdx::staffUpperBorder).val()    * _spatium;
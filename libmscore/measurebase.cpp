@@ -254,6 +254,19 @@ Measure* MeasureBase::prevMeasureMM() const
       return 0;
       }
 
+//---------------------------------------------------------
+//   setTick
+//---------------------------------------------------------
+
+void MeasureBase::setTick(int t)
+      {
+      if (t == _tick)
+            return;
+      _tick = t;
+      if (score())
+            score()->measures()->invalidateIndex();
+      }
+
 //---------------------------------------------------------
 //   pause
 //---------------------------------------------------------
@@ -119,7 +119,7 @@ class MeasureBase : public Element {
       virtual void remove(Element*) override;
       int tick() const                       { return _tick;  }
       int endTick() const                    { return tick() + ticks();  }
-      void setTick(int t)                    { _tick = t;     }
+      void setTick(int t);
 
       qreal pause() const;
 
@@ -0,0 +1,350 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2015 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include "memoryreport.h"
+#include "accidental.h"
+#include "ambitus.h"
+#include "arpeggio.h"
+#include "articulation.h"
+#include "bagpembell.h"
+#include "barline.h"
+#include "beam.h"
+#include "bend.h"
+#include "box.h"
+#include "bracket.h"
+#include "breath.h"
+#include "chord.h"
+#include "chordline.h"
+#include "clef.h"
+#include "dynamic.h"
+#include "figuredbass.h"
+#include "fingering.h"
+#include "fret.h"
+#include "glissando.h"
+#include "hairpin.h"
+#include "harmony.h"
+#include "hook.h"
+#include "icon.h"
+#include "image.h"
+#include "iname.h"
+#include "instrchange.h"
+#include "jump.h"
+#include "keysig.h"
+#include "lasso.h"
+#include "layoutbreak.h"
+#include "ledgerline.h"
+#include "lyrics.h"
+#include "marker.h"
+#include "measure.h"
+#include "note.h"
+#include "notedot.h"
+#include "noteline.h"
+#include "ossia.h"
+#include "ottava.h"
+#include "page.h"
+#include "pedal.h"
+#include "rehearsalmark.h"
+#include "repeat.h"
+#include "rest.h"
+#include "score.h"
+#include "segment.h"
+#include "shadownote.h"
+#include "slur.h"
+#include "spacer.h"
+#include "staffstate.h"
+#include "stafftext.h"
+#include "stafftype.h"
+#include "stem.h"
+#include "stemslash.h"
+#include "symbol.h"
+#include "system.h"
+#include "tempotext.h"
+#include "textframe.h"
+#include "text.h"
+#include "textline.h"
+#include "tie.h"
+#include "timesig.h"
+#include "tremolo.h"
+#include "tremolobar.h"
+#include "trill.h"
+#include "tuplet.h"
+#include "volta.h"
+
+#if defined(Q_OS_MAC)
+#include <malloc/malloc.h>
+#elif defined(Q_OS_LINUX) || defined(Q_OS_WIN)
+#include <malloc.h>
+#endif
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   allocSize
+//    size of the heap block at p as reported by the
+//    allocator, fallback if it cannot tell
+//---------------------------------------------------------
+
+static size_t allocSize(const void* p, size_t fallback)
+      {
+      if (!p)
+            return 0;
+#if defined(Q_OS_MAC)
+      return malloc_size(p);
+#elif defined(Q_OS_WIN)
+      return _msize(const_cast<void*>(p));
+#elif defined(Q_OS_LINUX) && defined(__GLIBC__)
+      return malloc_usable_size(const_cast<void*>(p));
+#else
+      return fallback;
+#endif
+      }
+
+//---------------------------------------------------------
+//   objectSize
+//    size of the class of an element
+//---------------------------------------------------------
+
+size_t MemoryReport::objectSize(const Element* e)
+      {
+      switch (e->type()) {
+            case Element::Type::INVALID:
+                  // FiguredBassItem is the only element without a type of its own
+                  if (dynamic_cast<const FiguredBassItem*>(e))
+                        return sizeof(FiguredBassItem);
+                  break;
+            case Element::Type::SYMBOL:               return sizeof(Symbol);
+            case Element::Type::TEXT:                 return sizeof(Text);
+            case Element::Type::INSTRUMENT_NAME:      return sizeof(InstrumentName);
+            case Element::Type::SLUR_SEGMENT:         return sizeof(SlurSegment);
+            case Element::Type::STAFF_LINES:          return sizeof(StaffLines);
+            case Element::Type::BAR_LINE:             return sizeof(BarLine);
+            case Element::Type::SYSTEM_DIVIDER:       return sizeof(SystemDivider);
+            case Element::Type::STEM_SLASH:           return sizeof(StemSlash);
+            case Element::Type::LINE:                 return sizeof(Line);
+            case Element::Type::ARPEGGIO:             return sizeof(Arpeggio);
+            case Element::Type::ACCIDENTAL:           return sizeof(Accidental);
+            case Element::Type::STEM:                 return sizeof(Stem);
+            case Element::Type::NOTE:                 return sizeof(Note);
+            case Element::Type::CLEF:                 return sizeof(Clef);
+            case Element::Type::KEYSIG:               return sizeof(KeySig);
+            case Element::Type::AMBITUS:              return sizeof(Ambitus);
+            case Element::Type::TIMESIG:              return sizeof(TimeSig);
+            case Element::Type::REST:                 return sizeof(Rest);
+            case Element::Type::BREATH:               return sizeof(Breath);
+            case Element::Type::REPEAT_MEASURE:       return sizeof(RepeatMeasure);
+            case Element::Type::IMAGE:                return sizeof(Image);
+            case Element::Type::TIE:                  return sizeof(Tie);
+            case Element::Type::ARTICULATION:         return sizeof(Articulation);
+            case Element::Type::CHORDLINE:            return sizeof(ChordLine);
+            case Element::Type::DYNAMIC:              return sizeof(Dynamic);
+            case Element::Type::BEAM:                 return sizeof(Beam);
+            case Element::Type::HOOK:                 return sizeof(Hook);
+            case Element::Type::LYRICS:               return sizeof(Lyrics);
+            case Element::Type::FIGURED_BASS:         return sizeof(FiguredBass);
+            case Element::Type::MARKER:               return sizeof(Marker);
+            case Element::Type::JUMP:                 return sizeof(Jump);
+            case Element::Type::FINGERING:            return sizeof(Fingering);
+            case Element::Type::TUPLET:               return sizeof(Tuplet);
+            case Element::Type::TEMPO_TEXT:           return sizeof(TempoText);
+            case Element::Type::STAFF_TEXT:           return sizeof(StaffText);
+            case Element::Type::REHEARSAL_MARK:       return sizeof(RehearsalMark);
+            case Element::Type::INSTRUMENT_CHANGE:    return sizeof(InstrumentChange);
+            case Element::Type::HARMONY:              return sizeof(Harmony);
+            case Element::Type::FRET_DIAGRAM:         return sizeof(FretDiagram);
+            case Element::Type::BEND:                 return sizeof(Bend);
+            case Element::Type::TREMOLOBAR:           return sizeof(TremoloBar);
+            case Element::Type::VOLTA:                return sizeof(Volta);
+            case Element::Type::HAIRPIN_SEGMENT:      return sizeof(HairpinSegment);
+            case Element::Type::OTTAVA_SEGMENT:       return sizeof(OttavaSegment);
+            case Element::Type::TRILL_SEGMENT:        return sizeof(TrillSegment);
+            case Element::Type::TEXTLINE_SEGMENT:     return sizeof(TextLineSegment);
+            case Element::Type::VOLTA_SEGMENT:        return sizeof(VoltaSegment);
+            case Element::Type::PEDAL_SEGMENT:        return sizeof(PedalSegment);
+            case Element::Type::LYRICSLINE_SEGMENT:   return sizeof(LyricsLineSegment);
+            case Element::Type::GLISSANDO_SEGMENT:    return sizeof(GlissandoSegment);
+            case Element::Type::LAYOUT_BREAK:         return sizeof(LayoutBreak);
+            case Element::Type::SPACER:               return sizeof(Spacer);
+            case Element::Type::STAFF_STATE:          return sizeof(StaffState);
+            case Element::Type::LEDGER_LINE:          return sizeof(LedgerLine);
+            case Element::Type::NOTEHEAD:             return sizeof(NoteHead);
+            case Element::Type::NOTEDOT:              return sizeof(NoteDot);
+            case Element::Type::TREMOLO:              return sizeof(Tremolo);
+            case Element::Type::MEASURE:              return sizeof(Measure);
+            case Element::Type::LASSO:                return sizeof(Lasso);
+            case Element::Type::SHADOW_NOTE:          return sizeof(ShadowNote);
+            case Element::Type::TAB_DURATION_SYMBOL:  return sizeof(TabDurationSymbol);
+            case Element::Type::FSYMBOL:              return sizeof(FSymbol);
+            case Element::Type::PAGE:                 return sizeof(Page);
+            case Element::Type::HAIRPIN:              return sizeof(Hairpin);
+            case Element::Type::OTTAVA:               return sizeof(Ottava);
+            case Element::Type::PEDAL:                return sizeof(Pedal);
+            case Element::Type::TRILL:                return sizeof(Trill);
+            case Element::Type::TEXTLINE:             return sizeof(TextLine);
+            case Element::Type::NOTELINE:             return sizeof(NoteLine);
+            case Element::Type::LYRICSLINE:           return sizeof(LyricsLine);
+            case Element::Type::GLISSANDO:            return sizeof(Glissando);
+            case Element::Type::BRACKET:              return sizeof(Bracket);
+            case Element::Type::SEGMENT:              return sizeof(Segment);
+            case Element::Type::SYSTEM:               return sizeof(System);
+            case Element::Type::CHORD:                return sizeof(Chord);
+            case Element::Type::SLUR:                 return sizeof(Slur);
+            case Element::Type::HBOX:                 return sizeof(HBox);
+            case Element::Type::VBOX:                 return sizeof(VBox);
+            case Element::Type::TBOX:                 return sizeof(TBox);
+            case Element::Type::FBOX:                 return sizeof(FBox);
+            case Element::Type::ICON:                 return sizeof(Icon);
+            case Element::Type::OSSIA:                return sizeof(Ossia);
+            case Element::Type::BAGPIPE_EMBELLISHMENT: return sizeof(BagpipeEmbellishment);
+            default:
+                  break;
+            }
+      return sizeof(Element);
+      }
+
+//---------------------------------------------------------
+//   qobjectSize
+//    memory an element would not need without QObject:
+//    the QObject base and its private data
+//---------------------------------------------------------
+
+size_t MemoryReport::qobjectSize(const Element* e)
+      {
+      return sizeof(QObject) + allocSize(e->objectData(), sizeof(QObjectData));
+      }
+
+//---------------------------------------------------------
+//   add
+//---------------------------------------------------------
+
+void MemoryReport::add(const Element* e)
+      {
+      if (!e || _seen.contains(e))
+            return;
+      _seen.insert(e);
+      size_t q  = qobjectSize(e);
+      Usage& u  = _types[int(e->type())];
+      u.count   += 1;
+      u.bytes   += objectSize(e) + q - sizeof(QObject);
+      u.qobject += q;
+      }
+
+//---------------------------------------------------------
+//   collect
+//---------------------------------------------------------
+
+void MemoryReport::collect(void* data, Element* e)
+      {
+      static_cast<MemoryReport*>(data)->add(e);
+      }
+
+//---------------------------------------------------------
+//   add
+//    all elements of a score and its parts. The score
+//    structure is walked explicitly as scanElements()
+//    only reports the leaves.
+//---------------------------------------------------------
+
+void MemoryReport::add(Score* score)
+      {
+      for (Score* s : score->scoreList()) {
+            for (Page* page : s->pages())
+                  add(page);
+            for (System* system : *s->systems())
+                  add(system);
+            for (MeasureBase* mb = s->first(); mb; mb = mb->next()) {
+                  add(mb);
+                  if (mb->type() != Element::Type::MEASURE)
+                        continue;
+                  Measure* m = static_cast<Measure*>(mb);
+                  for (Measure* mm : { m, m->mmRest() }) {
+                        if (!mm)
+                              continue;
+                        add(mm);
+                        for (Segment* seg = mm->first(); seg; seg = seg->next()) {
+                              add(seg);
+                              for (int track = 0; track < s->ntracks(); ++track) {
+                                    Element* e = seg->element(track);
+                                    if (!e)
+                                          continue;
+                                    add(e);
+                                    if (e->type() == Element::Type::CHORD) {
+                                          for (Chord* c : static_cast<Chord*>(e)->graceNotes())
+                                                add(c);
+                                          }
+                                    if (e->isChordRest()) {
+                                          ChordRest* cr = static_cast<ChordRest*>(e);
+                                          add(cr->beam());
+                                          for (Tuplet* t = cr->tuplet(); t; t = t->tuplet())
+                                                add(t);
+                                          }
+                                    }
+                              }
+                        }
+                  }
+            for (auto i : s->spanner())
+                  add(i.second);
+            s->scanElements(this, collect, true);
+            }
+      }
+
+//---------------------------------------------------------
+//   total
+//---------------------------------------------------------
+
+MemoryReport::Usage MemoryReport::total() const
+      {
+      Usage t;
+      for (const Usage& u : _types) {
+            t.count   += u.count;
+            t.bytes   += u.bytes;
+            t.qobject += u.qobject;
+            }
+      return t;
+      }
+
+//---------------------------------------------------------
+//   toString
+//    one line per element type, largest first
+//---------------------------------------------------------
+
+QString MemoryReport::toString() const
+      {
+      QList<int> types;
+      for (int i = 0; i < int(Element::Type::MAXTYPE); ++i) {
+            if (_types[i].count)
+                  types.append(i);
+            }
+      std::sort(types.begin(), types.end(), [this](int a, int b) { return _types[a].bytes > _types[b].bytes; });
+
+      auto line = [](const QString& name, const Usage& u) {
+            return QString("%1 %2 %3 %4 %5 %6\n")
+               .arg(name, -24)
+               .arg(u.count, 9)
+               .arg(u.bytes, 12)
+               .arg(u.count ? u.bytes / u.count : 0, 7)
+               .arg(u.qobject, 12)
+               .arg(u.bytes - u.qobject, 12);
+            };
+      QString s = QString("%1 %2 %3 %4 %5 %6\n")
+         .arg("type", -24).arg("count", 9).arg("bytes", 12).arg("avg", 7)
+         .arg("QObject", 12).arg("w/o QObject", 12);
+      for (int i : types)
+            s += line(Element::name(Element::Type(i)), _types[i]);
+      Usage t = total();
+      s += line("total", t);
+      if (t.bytes)
+            s += QString("QObject share: %1%\n").arg(t.qobject * 100.0 / t.bytes, 0, 'f', 1);
+      return s;
+      }
+
+}
+
@@ -0,0 +1,58 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2015 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __MEMORYREPORT_H__
+#define __MEMORYREPORT_H__
+
+#include "element.h"
+
+namespace Ms {
+
+class Score;
+
+//---------------------------------------------------------
+//   MemoryReport
+//    memory used by the elements of a score, by type.
+//    The QObject part of an element is its QObject base
+//    plus the private object data allocated with it.
+//---------------------------------------------------------
+
+class MemoryReport {
+   public:
+      struct Usage {
+            int count         { 0 };
+            qint64 bytes      { 0 };      // objects including QObject
+            qint64 qobject    { 0 };      // QObject part of bytes
+            };
+
+   private:
+      Usage _types[int(Element::Type::MAXTYPE)];
+      QSet<const Element*> _seen;
+
+      static void collect(void* data, Element* e);
+
+   public:
+      MemoryReport() {}
+      void add(const Element*);
+      void add(Score*);
+
+      const Usage& usage(Element::Type t) const { return _types[int(t)]; }
+      Usage total() const;
+      QString toString() const;
+
+      static size_t objectSize(const Element*);
+      static size_t qobjectSize(const Element*);
+      };
+
+}     // namespace Ms
+#endif
+
@@ -89,6 +89,7 @@ int     MScore::defaultPlayDuration;
 // QString MScore::partStyle;
 QString MScore::lastError;
 bool    MScore::layoutDebug = false;
+bool    MScore::parallelLayout = true;     // run independent layout stages on the thread pool
 int     MScore::division    = 480; // 3840;   // pulses per quarter note (PPQ) // ticks per beat
 int     MScore::sampleRate  = 44100;
 int     MScore::mtcType;
@@ -396,6 +396,7 @@ class MScore : public QObject {
       static int defaultPlayDuration;
       static QString lastError;
       static bool layoutDebug;
+      static bool parallelLayout;
 
       static int division;
       static int sampleRate;
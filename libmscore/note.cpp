@@ -759,6 +759,19 @@ void Note::draw(QPainter* painter) const
             }
       }
 
+//---------------------------------------------------------
+//   cutOff
+//    true if the end note of s is not written by
+//    Score::write(..., end); s is dropped then
+//---------------------------------------------------------
+
+static bool cutOff(const Xml& xml, const Spanner* s)
+      {
+      const Element* e = s->endElement();
+      return xml.cutTick != -1 && e && e->type() == Element::Type::NOTE
+         && static_cast<const Note*>(e)->chord()->tick() >= xml.cutTick;
+      }
+
 //--------------------------------------------------
 //   Note::write
 //---------------------------------------------------------
@@ -782,7 +795,7 @@ void Note::write(Xml& xml) const
                         }
                   }
             }
-      if (_tieFor)
+      if (_tieFor && !cutOff(xml, _tieFor))
             _tieFor->write(xml);
       if (_tieBack) {
             int id = xml.spannerId(_tieBack);
@@ -814,8 +827,10 @@ void Note::write(Xml& xml) const
       writeProperty(xml, P_ID::FIXED);
       writeProperty(xml, P_ID::FIXED_LINE);
 
-      foreach (Spanner* e, _spannerFor)
-            e->write(xml);
+      foreach (Spanner* e, _spannerFor) {
+            if (!cutOff(xml, e))
+                  e->write(xml);
+            }
       foreach (Spanner* e, _spannerBack)
             xml.tagE(QString("endSpanner id=\"%1\"").arg(xml.spannerId(e)));
 
@@ -38,6 +38,7 @@
 #include "sig.h"
 #include "repeatlist.h"
 #include "velo.h"
+#include "trace.h"
 #include "dynamic.h"
 #include "navigate.h"
 #include "pedal.h"
@@ -441,6 +442,7 @@ void Score::updateRepeatList(bool expandRepeats)
             s->utime = 0.0;
             s->timeOffset = 0.0;
             repeatList()->append(s);
+            repeatList()->update();
             }
       else
             repeatList()->unwind();
@@ -1580,6 +1582,7 @@ int Score::renderMetronome(EventMap* events, Measure* m, int playPos, int tickOf
 
 void Score::renderMidi(EventMap* events)
       {
+      TRACE_SCOPE("renderMidi");
       updateSwing();
       createPlayEvents();
 
@@ -1611,5 +1614,189 @@ void Score::renderMidi(EventMap* events)
                   }
             }
       }
+
+//---------------------------------------------------------
+//   RenderWindow
+//    events of one repeat of the changed range
+//---------------------------------------------------------
+
+struct RenderWindow {
+      int utick1;
+      int utick2;
+      EventMap events;
+      };
+
+//---------------------------------------------------------
+//   renderMidiRange
+//    Update an event list created by renderMidi() after
+//    the notes between stick and etick have changed. The
+//    note, pitch bend, controller, pedal and metronome
+//    events of these measures are removed and rendered
+//    again for every repeat segment; all other events are
+//    kept. Returns false if this is not possible and
+//    renderMidi() is needed.
+//---------------------------------------------------------
+
+bool Score::renderMidiRange(EventMap* events, int stick, int etick)
+      {
+      if (stick == -1 || events->empty())
+            return false;
+      if (stick == INT_MAX)         // nothing changed
+            return true;
+
+      // extend the range to complete tie chains, their
+      // events are rendered by the first note
+      const Segment::Type st = Segment::Type::ChordRest;
+      bool changed = true;
+      while (changed) {
+            changed = false;
+            for (Measure* m = firstMeasure(); m && m->tick() < etick; m = m->nextMeasure()) {
+                  if (m->endTick() <= stick)
+                        continue;
+                  for (Segment* s = m->first(st); s; s = s->next(st)) {
+                        for (int track = 0; track < ntracks(); ++track) {
+                              Element* e = s->element(track);
+                              if (!e || e->type() != Element::Type::CHORD)
+                                    continue;
+                              for (Note* n : static_cast<Chord*>(e)->notes()) {
+                                    int t1 = n->firstTiedNote()->chord()->measure()->tick();
+                                    int t2 = n->lastTiedNote()->chord()->measure()->endTick();
+                                    if (t1 < stick) {
+                                          stick   = t1;
+                                          changed = true;
+                                          }
+                                    if (t2 > etick) {
+                                          etick   = t2;
+                                          changed = true;
+                                          }
+                                    }
+                              }
+                        }
+                  }
+            }
+
+      QList<Measure*> ml;
+      for (Measure* m = firstMeasure(); m && m->tick() < etick; m = m->nextMeasure()) {
+            if (m->endTick() > stick)
+                  ml.append(m);
+            }
+      if (ml.isEmpty())
+            return false;
+      stick = ml.first()->tick();
+      etick = ml.last()->endTick();
+
+      // repeat measures replay the events of a previous measure
+      Measure* nm = ml.last()->nextMeasure();
+      for (Staff* staff : _staves) {
+            if (nm && nm->isRepeatMeasure(staff))
+                  return false;
+            for (Measure* m : ml) {
+                  if (m->isRepeatMeasure(staff))
+                        return false;
+                  }
+            }
+
+      // update play events and channels of the changed chords
+      for (Measure* m : ml) {
+            for (Segment* s = m->first(st); s; s = s->next(st)) {
+                  for (int track = 0; track < ntracks(); ++track) {
+                        Element* e = s->element(track);
+                        if (!e || e->type() != Element::Type::CHORD)
+                              continue;
+                        Chord* c = static_cast<Chord*>(e);
+                        if (!c->staff()->primaryStaff())
+                              continue;
+                        createPlayEvents(c);
+                        int channel = c->staff()->channel(c->tick(), c->voice());
+                        for (Note* note : c->notes()) {
+                              if (!note->hidden() && !note->tieBack())
+                                    note->setSubchannel(channel);
+                              }
+                        }
+                  }
+            }
+
+      // pedal events depend on the neighbouring pedals of the
+      // same channel; take the ones of the range from a render
+      // of all pedals
+      EventMap pedals;
+      renderSpanners(&pedals, -1);
+
+      // render the range for every repeat
+      QList<RenderWindow> windows;
+      for (const RepeatSegment* rs : *repeatList()) {
+            int t1 = qMax(stick, rs->tick);
+            int t2 = qMin(etick, rs->tick + rs->len);
+            if (t1 >= t2)
+                  continue;
+            int tickOffset = rs->utick - rs->tick;
+            windows.append(RenderWindow());
+            RenderWindow& w = windows.last();
+            w.utick1 = t1 + tickOffset;
+            w.utick2 = t2 + tickOffset;
+            for (Measure* m : ml) {
+                  if (m->tick() < t1 || m->tick() >= t2)
+                        continue;
+                  for (Staff* staff : _staves)
+                        collectMeasureEvents(&w.events, m, staff, tickOffset);
+                  renderMetronome(&w.events, m, m->tick(), tickOffset, false);
+                  }
+            // pedal off events are one tick after the pedal end
+            for (auto i = pedals.lower_bound(w.utick1); i != pedals.end() && i->first < w.utick2 + 2; ++i)
+                  w.events.insert(*i);
+            }
+
+      // splice the new events into the event list
+      for (const RenderWindow& w : windows) {
+            QSet<const Note*> notes;
+            int pending = 0;        // note off events still to remove
+            for (auto i = events->lower_bound(w.utick1); i != events->end() && i->first < w.utick2 + 2;) {
+                  const NPlayEvent& ev = i->second;
+                  bool inside = i->first < w.utick2;
+                  if (inside && ev.type() == ME_NOTEON && ev.velo() && ev.note()) {
+                        notes.insert(ev.note());
+                        ++pending;
+                        i = events->erase(i);
+                        }
+                  else if ((inside && ev.type() != ME_NOTEON)
+                     || (ev.type() == ME_CONTROLLER && ev.controller() == CTRL_SUSTAIN))
+                        i = events->erase(i);       // rendered again below
+                  else
+                        ++i;
+                  }
+            for (auto i = events->lower_bound(w.utick1); pending && i != events->end();) {
+                  const NPlayEvent& ev = i->second;
+                  if (ev.type() == ME_NOTEON && !ev.velo() && notes.contains(ev.note())) {
+                        --pending;
+                        i = events->erase(i);
+                        }
+                  else
+                        ++i;
+                  }
+            for (const auto& p : w.events) {
+                  const NPlayEvent& ev = p.second;
+                  if (p.first < w.utick2 || ev.type() == ME_NOTEON
+                     || (ev.type() == ME_CONTROLLER && ev.controller() == CTRL_SUSTAIN)) {
+                        events->insert(p);
+                        continue;
+                        }
+                  // the bend of a note ending with the range is
+                  // reset after it; the old reset is still there
+                  // unless the note lost its bend
+                  if (ev.type() == ME_PITCHBEND) {
+                        bool found = false;
+                        for (auto i = events->lower_bound(p.first); i != events->end() && i->first == p.first; ++i) {
+                              if (i->second == ev) {
+                                    found = true;
+                                    break;
+                                    }
+                              }
+                        if (!found)
+                              events->insert(p);
+                        }
+                  }
+            }
+      return true;
+      }
 }
 
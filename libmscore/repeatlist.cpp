@@ -143,6 +143,69 @@ void RepeatList::update()
             utick        += s->len;
             t            += tl->tick2time(s->tick + s->len) - ct;
             }
+
+      _tickBounds.clear();
+      _tickSegment.clear();
+      for (const RepeatSegment* s : *this) {
+            _tickBounds.append(s->tick);
+            _tickBounds.append(s->tick + s->len);
+            }
+      std::sort(_tickBounds.begin(), _tickBounds.end());
+      _tickBounds.erase(std::unique(_tickBounds.begin(), _tickBounds.end()), _tickBounds.end());
+      _tickSegment.fill(-1, qMax(_tickBounds.size() - 1, 0));
+      for (int i = 0; i < _tickSegment.size(); ++i) {
+            int tick = _tickBounds[i];
+            for (int k = 0; k < size(); ++k) {
+                  const RepeatSegment* s = at(k);
+                  if (tick >= s->tick && tick < (s->tick + s->len)) {
+                        _tickSegment[i] = k;
+                        break;
+                        }
+                  }
+            }
+      idx1 = 0;
+      idx2 = 0;
+      }
+
+//---------------------------------------------------------
+//   findUtick
+//    return index of the segment containing utick;
+//    sequential access is answered from the cached index
+//---------------------------------------------------------
+
+unsigned RepeatList::findUtick(int tick) const
+      {
+      unsigned n = size();
+      if (idx1 < n && tick >= at(idx1)->utick) {
+            if (idx1 + 1 == n || tick < at(idx1 + 1)->utick)
+                  return idx1;
+            if (idx1 + 2 == n || tick < at(idx1 + 2)->utick)
+                  return ++idx1;
+            }
+      auto i = std::upper_bound(begin(), end(), tick,
+         [](int t, const RepeatSegment* s) { return t < s->utick; });
+      idx1 = (i == begin()) ? 0 : (i - begin()) - 1;
+      return idx1;
+      }
+
+//---------------------------------------------------------
+//   findUtime
+//    return index of the segment containing utime
+//---------------------------------------------------------
+
+unsigned RepeatList::findUtime(qreal t) const
+      {
+      unsigned n = size();
+      if (idx2 < n && t >= at(idx2)->utime) {
+            if (idx2 + 1 == n || t < at(idx2 + 1)->utime)
+                  return idx2;
+            if (idx2 + 2 == n || t < at(idx2 + 2)->utime)
+                  return ++idx2;
+            }
+      auto i = std::upper_bound(begin(), end(), t,
+         [](qreal tt, const RepeatSegment* s) { return tt < s->utime; });
+      idx2 = (i == begin()) ? 0 : (i - begin()) - 1;
+      return idx2;
       }
 
 //---------------------------------------------------------
@@ -156,17 +219,8 @@ int RepeatList::utick2tick(int tick) const
             return tick;
       if (tick < 0)
             return 0;
-      unsigned ii = (idx1 < n) && (tick >= at(idx1)->utick) ? idx1 : 0;
-      for (unsigned i = ii; i < n; ++i) {
-            if ((tick >= at(i)->utick) && ((i + 1 == n) || (tick < at(i+1)->utick))) {
-                  idx1 = i;
-                  return tick - (at(i)->utick - at(i)->tick);
-                  }
-            }
-      if (MScore::debugMode) {
-            qFatal("tick %d not found in RepeatList", tick);
-            }
-      return 0;
+      const RepeatSegment* s = at(findUtick(tick));
+      return tick - (s->utick - s->tick);
       }
 
 //---------------------------------------------------------
@@ -175,9 +229,11 @@ int RepeatList::utick2tick(int tick) const
 
 int RepeatList::tick2utick(int tick) const
       {
-      for (const RepeatSegment* s : *this) {
-            if (tick >= s->tick && tick < (s->tick + s->len))
-                  return s->utick + (tick - s->tick);
+      auto i = std::upper_bound(_tickBounds.begin(), _tickBounds.end(), tick);
+      int k = (i - _tickBounds.begin()) - 1;
+      if (k >= 0 && k < _tickSegment.size() && _tickSegment[k] != -1) {
+            const RepeatSegment* s = at(_tickSegment[k]);
+            return s->utick + (tick - s->tick);
             }
       return last()->utick + (tick - last()->tick);
       }
@@ -188,16 +244,11 @@ int RepeatList::tick2utick(int tick) const
 
 qreal RepeatList::utick2utime(int tick) const
       {
-      unsigned n = size();
-      unsigned ii = (idx1 < n) && (tick >= at(idx1)->utick) ? idx1 : 0;
-      for (unsigned i = ii; i < n; ++i) {
-            if ((tick >= at(i)->utick) && ((i + 1 == n) || (tick < at(i+1)->utick))) {
-                  int t     = tick - (at(i)->utick - at(i)->tick);
-                  qreal tt = _score->tempomap()->tick2time(t) + at(i)->timeOffset;
-                  return tt;
-                  }
-            }
-      return 0.0;
+      if (isEmpty() || tick < 0)
+            return 0.0;
+      const RepeatSegment* s = at(findUtick(tick));
+      int t = tick - (s->utick - s->tick);
+      return _score->tempomap()->tick2time(t) + s->timeOffset;
       }
 
 //---------------------------------------------------------
@@ -206,18 +257,10 @@ qreal RepeatList::utick2utime(int tick) const
 
 int RepeatList::utime2utick(qreal t) const
       {
-      unsigned n = size();
-      unsigned ii = (idx2 < n) && (t >= at(idx2)->utime) ? idx2 : 0;
-      for (unsigned i = ii; i < n; ++i) {
-            if ((t >= at(i)->utime) && ((i + 1 == n) || (t < at(i+1)->utime))) {
-                  idx2 = i;
-                  return _score->tempomap()->time2tick(t - at(i)->timeOffset) + (at(i)->utick - at(i)->tick);
-                  }
-            }
-      if (MScore::debugMode) {
-            qFatal("time %f not found in RepeatList", t);
-            }
-      return 0;
+      if (isEmpty() || t < 0.0)
+            return 0;
+      const RepeatSegment* s = at(findUtime(t));
+      return _score->tempomap()->time2tick(t - s->timeOffset) + (s->utick - s->tick);
       }
 
 //---------------------------------------------------------
@@ -44,7 +44,14 @@ class RepeatList: public QList<RepeatSegment*>
 
       RepeatSegment* rs;            // tmp value during unwind()
 
+      // tick2utick() index: sorted segment boundaries and, for every
+      // interval between two boundaries, the first segment playing it (or -1)
+      QVector<int> _tickBounds;
+      QVector<int> _tickSegment;
+
       Measure* jumpToStartRepeat(Measure*);
+      unsigned findUtick(int utick) const;
+      unsigned findUtime(qreal utime) const;
 
    public:
       RepeatList(Score* s);
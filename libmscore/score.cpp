@@ -17,6 +17,7 @@
 
 #include <assert.h>
 #include "score.h"
+#include "ledgerline.h"
 #include "key.h"
 #include "sig.h"
 #include "clef.h"
@@ -88,9 +89,11 @@ bool showRubberBand  = true;
 
 MeasureBaseList::MeasureBaseList()
       {
-      _first = 0;
-      _last  = 0;
-      _size  = 0;
+      _first        = 0;
+      _last         = 0;
+      _size         = 0;
+      _indexValid   = false;
+      _indexOrdered = false;
       };
 
 //---------------------------------------------------------
@@ -140,6 +143,7 @@ void MeasureBaseList::push_front(MeasureBase* e)
 
 void MeasureBaseList::add(MeasureBase* e)
       {
+      invalidateIndex();
       MeasureBase* el = e->next();
       if (el == 0) {
             push_back(e);
@@ -161,6 +165,7 @@ void MeasureBaseList::add(MeasureBase* e)
 
 void MeasureBaseList::remove(MeasureBase* el)
       {
+      invalidateIndex();
       --_size;
       if (el->prev())
             el->prev()->setNext(el->next());
@@ -178,6 +183,7 @@ void MeasureBaseList::remove(MeasureBase* el)
 
 void MeasureBaseList::insert(MeasureBase* fm, MeasureBase* lm)
       {
+      invalidateIndex();
       ++_size;
       for (MeasureBase* m = fm; m != lm; m = m->next())
             ++_size;
@@ -199,6 +205,7 @@ void MeasureBaseList::insert(MeasureBase* fm, MeasureBase* lm)
 
 void MeasureBaseList::remove(MeasureBase* fm, MeasureBase* lm)
       {
+      invalidateIndex();
       --_size;
       for (MeasureBase* m = fm; m != lm; m = m->next())
             --_size;
@@ -220,6 +227,7 @@ void MeasureBaseList::remove(MeasureBase* fm, MeasureBase* lm)
 
 void MeasureBaseList::change(MeasureBase* ob, MeasureBase* nb)
       {
+      invalidateIndex();
       nb->setPrev(ob->prev());
       nb->setNext(ob->next());
       if (ob->prev())
@@ -237,6 +245,75 @@ void MeasureBaseList::change(MeasureBase* ob, MeasureBase* nb)
             e->setParent(nb);
       }
 
+//---------------------------------------------------------
+//   measureIndex
+//    all measures of the list for binary search by tick,
+//    rebuilt after the list or the tick of a measure has
+//    changed. Returns 0 if the measure ticks are not in
+//    order (before fixTicks()).
+//---------------------------------------------------------
+
+const QVector<Measure*>* MeasureBaseList::measureIndex() const
+      {
+      QMutexLocker lock(&_indexMutex);
+      return buildMeasureIndex();
+      }
+
+//---------------------------------------------------------
+//   buildMeasureIndex
+//    called with _indexMutex held
+//---------------------------------------------------------
+
+const QVector<Measure*>* MeasureBaseList::buildMeasureIndex() const
+      {
+      if (!_indexValid) {
+            _index.clear();
+            _index.reserve(_size);
+            _indexOrdered = true;
+            for (MeasureBase* mb = _first; mb; mb = mb->next()) {
+                  if (mb->type() != Element::Type::MEASURE)
+                        continue;
+                  Measure* m = static_cast<Measure*>(mb);
+                  if (!_index.isEmpty() && m->tick() < _index.last()->tick())
+                        _indexOrdered = false;
+                  _index.append(m);
+                  }
+            _indexValid = true;
+            }
+      return _indexOrdered ? &_index : 0;
+      }
+
+//---------------------------------------------------------
+//   chordRestIndex
+//    the chords and rests of track in tick order for
+//    binary search, built on demand and dropped when a
+//    segment, its elements or the measure list change.
+//    Returns 0 if the ticks are not in order.
+//---------------------------------------------------------
+
+const QVector<ChordRest*>* MeasureBaseList::chordRestIndex(int track) const
+      {
+      QMutexLocker lock(&_indexMutex);
+      auto i = _crIndex.constFind(track);
+      if (i != _crIndex.constEnd())
+            return &i.value();
+      const QVector<Measure*>* measures = buildMeasureIndex();
+      if (!measures)
+            return 0;
+      QVector<ChordRest*> index;
+      for (Measure* m : *measures) {
+            for (Segment* s = m->first(Segment::Type::ChordRest); s; s = s->next(Segment::Type::ChordRest)) {
+                  ChordRest* cr = static_cast<ChordRest*>(s->element(track));
+                  if (!cr)
+                        continue;
+                  if (!index.isEmpty() && cr->tick() < index.last()->tick())
+                        return 0;
+                  index.append(cr);
+                  }
+            }
+      return &_crIndex.insert(track, index).value();
+      }
+
 //---------------------------------------------------------
 //   init
 //---------------------------------------------------------
@@ -286,6 +363,8 @@ void Score::init()
       _scoreFont = ScoreFont::fontFactory("emmentaler");
 
       _pageNumberOffset = 0;
+      _layoutStartTick  = -1;
+      _layoutEndTick    = -1;
 
       _mscVersion             = MSCVERSION;
       _created                = false;
@@ -310,6 +389,8 @@ void Score::init()
 
       _printing               = false;
       _playlistDirty          = true;
+      _playlistStartTick      = INT_MAX;
+      _playlistEndTick        = -1;
       _autosaveDirty          = true;
       _saved                  = false;
       _pos[int(POS::CURRENT)] = 0;
@@ -3303,6 +3384,50 @@ void Score::undo(UndoCommand* cmd) const
       undo()->push(cmd);
       }
 
+//---------------------------------------------------------
+//   setPlaylistDirty
+//    Changes outside of a command invalidate the whole
+//    playlist. Inside of a command endCmd() computes the
+//    changed range from the undo operations.
+//---------------------------------------------------------
+
+void Score::setPlaylistDirty()
+      {
+      _playlistDirty = true;
+      if (!undo()->active())
+            _playlistStartTick = -1;
+      }
+
+//---------------------------------------------------------
+//   addPlaylistRange
+//    the events between stick and etick have to be
+//    rendered again; a stick of -1 invalidates all events
+//---------------------------------------------------------
+
+void Score::addPlaylistRange(int stick, int etick)
+      {
+      if (stick == -1)
+            _playlistStartTick = -1;
+      else {
+            _playlistStartTick = qMin(_playlistStartTick, stick);
+            _playlistEndTick   = qMax(_playlistEndTick, etick);
+            }
+      }
+
+//---------------------------------------------------------
+//   playlistRange
+//    range of changed events since the last
+//    playlistChanged(); stick is -1 if all events have
+//    to be rendered again and INT_MAX if no range was
+//    recorded
+//---------------------------------------------------------
+
+void Score::playlistRange(int* stick, int* etick) const
+      {
+      *stick = _playlistStartTick;
+      *etick = _playlistEndTick;
+      }
+
 //---------------------------------------------------------
 //   setLayoutMode
 //---------------------------------------------------------
@@ -27,6 +27,7 @@
 #include "ottava.h"
 #include "spannermap.h"
 #include "rehearsalmark.h"
+#include "elementpool.h"
 #include <set>
 
 class QPainter;
@@ -40,6 +41,7 @@ class Beam;
 class Bracket;
 class BSymbol;
 class Chord;
+class LedgerLine;
 class ChordRest;
 class Clef;
 class Cursor;
@@ -139,20 +141,39 @@ class MeasureBaseList {
       MeasureBase* _first;
       MeasureBase* _last;
 
+      mutable QVector<Measure*> _index;   // measures in list order, see measureIndex()
+      mutable bool _indexValid;
+      mutable bool _indexOrdered;
+      mutable QHash<int, QVector<ChordRest*>> _crIndex;   // per track, see chordRestIndex()
+      mutable QMutex _indexMutex;         // guards the lazy index rebuild, pages are laid out in parallel
+
       void push_back(MeasureBase* e);
+      const QVector<Measure*>* buildMeasureIndex() const;
       void push_front(MeasureBase* e);
 
    public:
       MeasureBaseList();
       MeasureBase* first() const { return _first; }
       MeasureBase* last()  const { return _last; }
-      void clear()               { _first = _last = 0; _size = 0; }
+      void clear()               { _first = _last = 0; _size = 0; invalidateIndex(); }
       void add(MeasureBase*);
       void remove(MeasureBase*);
       void insert(MeasureBase*, MeasureBase*);
       void remove(MeasureBase*, MeasureBase*);
       void change(MeasureBase* o, MeasureBase* n);
       int size() const { return _size; }
+      void invalidateIndex() {
+            if (!_indexValid)             // chord/rest index is only built on a valid measure index
+                  return;
+            _indexValid = false;
+            invalidateChordRestIndex();
+            }
+      void invalidateChordRestIndex() {
+            if (_indexValid && !_crIndex.isEmpty())
+                  _crIndex.clear();
+            }
+      const QVector<Measure*>* measureIndex() const;
+      const QVector<ChordRest*>* chordRestIndex(int track) const;
       };
 
 //---------------------------------------------------------
@@ -218,6 +239,25 @@ struct Layer {
       uint tags;
       };
 
+//---------------------------------------------------------
+//   MsczSnapshot
+//    contents of a compressed score file; taken on the gui
+//    thread by Score::msczSnapshot() and written by
+//    Score::writeMscz() on any thread
+//---------------------------------------------------------
+
+struct MsczSnapshot {
+      struct File {
+            QString path;
+            QByteArray data;
+            QImage image;           // saved as png if not null
+            };
+      QList<File> files;
+
+      void add(const QString& path, const QByteArray& data) { files.append({ path, data, QImage() }); }
+      void add(const QString& path, const QImage& image)    { files.append({ path, QByteArray(), image }); }
+      };
+
 enum class PasteStatus : char {
       PS_NO_ERROR,
       NO_MIME,
@@ -315,9 +355,12 @@ class Score : public QObject {
 
       ScoreFont* _scoreFont;
       int _pageNumberOffset;        ///< Offset for page numbers.
+      int _layoutStartTick;         ///< range of measures laid out by the last layout,
+      int _layoutEndTick;           ///< -1: all measures
 
       MeasureBaseList _measures;          // here are the notes
       SpannerMap _spanner;
+      ElementPool<LedgerLine> _ledgerLinePool { this };     // recycled by chord layout
       std::set<Spanner*> _unmanagedSpanner;
 
       //
@@ -375,6 +418,8 @@ class Score : public QObject {
 
       bool _printing;   ///< True if we are drawing to a printer
       bool _playlistDirty;
+      int _playlistStartTick;       ///< tick range of local changes since the last
+      int _playlistEndTick;         ///< playlistChanged(); start INT_MAX: none, -1: all
       bool _autosaveDirty;
 //      bool _dirty;      ///< Score data was modified.
       bool _saved;      ///< True if project was already saved; only on first
@@ -456,7 +501,7 @@ class Score : public QObject {
       bool doReLayout();
 
       void layoutStage2();
-      void layoutStage3();
+      void layoutStage3(int stick = -1, int etick = -1);
       void beamGraceNotes(Chord*, bool);
 
       void hideEmptyStaves(System* system, bool isFirstSystem);
@@ -534,7 +579,7 @@ class Score : public QObject {
 
       int pageIdx(Page* page) const { return _pages.indexOf(page); }
 
-      void write(Xml&, bool onlySelection);
+      void write(Xml&, bool onlySelection, MeasureBase* end = 0);
       bool read(XmlReader&);
 
       QList<Staff*>& staves()                { return _staves; }
@@ -681,6 +726,8 @@ class Score : public QObject {
       void saveFile(QIODevice* f, bool msczFormat, bool onlySelection = false);
       void saveCompressedFile(QFileInfo&, bool onlySelection);
       void saveCompressedFile(QIODevice*, QFileInfo&, bool onlySelection);
+      MsczSnapshot msczSnapshot(const QFileInfo&, bool onlySelection, bool thumbnail = true);
+      static void writeMscz(QIODevice*, const MsczSnapshot&);
       bool exportFile();
 
       void print(QPainter* printer, int page);
@@ -734,7 +781,9 @@ class Score : public QObject {
       void setAutosaveDirty(bool v)  { _autosaveDirty = v;    }
       bool autosaveDirty() const     { return _autosaveDirty; }
       bool playlistDirty()           { return _playlistDirty; }
-      void setPlaylistDirty()        { _playlistDirty = true; }
+      void setPlaylistDirty();
+      void addPlaylistRange(int stick, int etick);
+      void playlistRange(int* stick, int* etick) const;
 
       void spell();
       void spell(int startStaff, int endStaff, Segment* startSegment, Segment* endSegment);
@@ -784,6 +833,7 @@ class Score : public QObject {
       bool pasteStaff(XmlReader&, Segment* dst, int staffIdx);
       void pasteSymbols(XmlReader& e, ChordRest* dst);
       void renderMidi(EventMap* events);
+      bool renderMidiRange(EventMap* events, int stick, int etick);
       void renderStaff(EventMap* events, Staff*);
       void renderSpanners(EventMap* events, int staffIdx);
       int renderMetronome(EventMap* events, Measure* m, int playPos, int tickOffset, bool countIn);
@@ -912,6 +962,7 @@ class Score : public QObject {
 
       //@ ??
       Q_INVOKABLE void doLayout();
+      void doLayoutRange(int stick, int etick);
       void layoutSystems();
       void layoutSystems2();
       void layoutLinear();
@@ -956,6 +1007,8 @@ class Score : public QObject {
       void cmdSplitMeasure(ChordRest*);
       void cmdJoinMeasure(Measure*, Measure*);
       int pageNumberOffset() const          { return _pageNumberOffset; }
+      int layoutStartTick() const           { return _layoutStartTick; }
+      int layoutEndTick() const             { return _layoutEndTick;   }
       void setPageNumberOffset(int v)       { _pageNumberOffset = v; }
 
       QString mscoreVersion() const         { return _mscoreVersion; }
@@ -1044,6 +1097,7 @@ class Score : public QObject {
       void insertTime(int tickPos, int tickLen);
 
       ScoreFont* scoreFont() const            { return _scoreFont;     }
+      ElementPool<LedgerLine>& ledgerLinePool() { return _ledgerLinePool; }
       void setScoreFont(ScoreFont* f)         { _scoreFont = f;        }
 
       qreal noteHeadWidth() const     { return _noteHeadWidth; }
@@ -1087,6 +1141,7 @@ class Score : public QObject {
       QString accessibleInfo()          { return accInfo;          }
 
       QImage createThumbnail();
+      MeasureBase* firstPageEnd();
       QString createRehearsalMarkText(RehearsalMark* current) const;
       QString nextRehearsalMarkText(RehearsalMark* previous, RehearsalMark* current) const;
 
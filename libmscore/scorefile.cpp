@@ -44,6 +44,7 @@
 #include "imageStore.h"
 #include "audio.h"
 #include "barline.h"
+#include "trace.h"
 #include "thirdparty/qzip/qzipreader_p.h"
 #include "thirdparty/qzip/qzipwriter_p.h"
 #ifdef Q_OS_WIN
@@ -84,9 +85,11 @@ static void writeMeasure(Xml& xml, MeasureBase* m, int staffIdx, bool writeSyste
 
 //---------------------------------------------------------
 //   write
+//    if end is not 0, only the measures before end are
+//    written, without page list and excerpts
 //---------------------------------------------------------
 
-void Score::write(Xml& xml, bool selectionOnly)
+void Score::write(Xml& xml, bool selectionOnly, MeasureBase* end)
       {
       // if we have multi measure rests and some parts are hidden,
       // then some layout information is missing:
@@ -169,7 +172,7 @@ void Score::write(Xml& xml, bool selectionOnly)
                   xml.tag(QString("metaTag name=\"%1\"").arg(i.key().toHtmlEscaped()), i.value());
             }
 
-      if (!selectionOnly) {
+      if (!selectionOnly && !end) {
             xml.stag("PageList");
             foreach(Page* page, _pages)
                   page->write(xml);
@@ -202,7 +205,7 @@ void Score::write(Xml& xml, bool selectionOnly)
             staffStart   = 0;
             staffEnd     = nstaves();
             measureStart = first();
-            measureEnd   = 0;
+            measureEnd   = end;
             }
 
       foreach(const Part* part, _parts) {
@@ -212,6 +215,8 @@ void Score::write(Xml& xml, bool selectionOnly)
 
       xml.curTrack = 0;
       xml.trackDiff = -staffStart * VOICES;
+      if (end)
+            xml.cutTick = end->tick();
       if (measureStart) {
             for (int staffIdx = staffStart; staffIdx < staffEnd; ++staffIdx) {
                   xml.stag(QString("Staff id=\"%1\"").arg(staffIdx + 1 - staffStart));
@@ -225,7 +230,8 @@ void Score::write(Xml& xml, bool selectionOnly)
                   }
             }
       xml.curTrack = -1;
-      if (!selectionOnly) {
+      xml.cutTick  = -1;
+      if (!selectionOnly && !end) {
             for (const Excerpt* excerpt : _excerpts) {
                   if (excerpt->partScore() != this)
                         excerpt->partScore()->write(xml, false);       // recursion
@@ -467,18 +473,73 @@ void Score::saveCompressedFile(QFileInfo& info, bool onlySelection)
       fp.close();
       }
 
+//---------------------------------------------------------
+//   firstPageEnd
+//    estimate the first measure after the first page in
+//    page mode from the measure widths of the current
+//    layout; errs on the long side
+//---------------------------------------------------------
+
+MeasureBase* Score::firstPageEnd()
+      {
+      qreal w = pageFormat()->printableWidth() * MScore::DPI;
+      qreal h = pageFormat()->height() * MScore::DPI;
+      qreal systemHeight = styleP(StyleIdx::minSystemDistance);
+      for (Staff* staff : _staves)
+            systemHeight += staff->height() + styleP(StyleIdx::staffDistance);
+      int systems = int(h / systemHeight) + 1;
+
+      // page mode adds clefs, key and time signatures to every
+      // system and does not stretch as tight as line mode
+      qreal width = systems * w * 1.5;
+      for (MeasureBase* m = first(); m; m = m->next()) {
+            switch (m->type()) {
+                  case Element::Type::VBOX:
+                  case Element::Type::TBOX:
+                  case Element::Type::FBOX:
+                        width -= w;
+                        break;
+                  default:
+                        width -= m->width();
+                        break;
+                  }
+            if (width <= 0.0 || m->pageBreak())
+                  return m->next();
+            }
+      return 0;
+      }
+
 //---------------------------------------------------------
 //   createThumbnail
+//    render the first page in page mode. In other modes a
+//    throwaway copy of the measures of the first page is
+//    laid out; the score itself and its undo stack are not
+//    touched.
 //---------------------------------------------------------
 
 QImage Score::createThumbnail()
       {
-      LayoutMode layoutMode = _layoutMode;
-      if (layoutMode != LayoutMode::PAGE) {
-            startCmd();
-            undo(new ChangeLayoutMode(this, LayoutMode::PAGE));
-            doLayout();
+      if (_layoutMode != LayoutMode::PAGE) {
+            QBuffer buffer;
+            buffer.open(QIODevice::WriteOnly);
+            Xml xml(&buffer);
+            xml.header();
+            xml.stag("museScore version=\"" MSC_VERSION "\"");
+            write(xml, false, firstPageEnd());
+            xml.etag();
+            buffer.close();
+
+            XmlReader r(buffer.buffer());
+            Score* score = new Score(style());
+            score->read1(r, true);
+            score->_layoutMode = LayoutMode::PAGE;
+            score->addLayoutFlags(LayoutFlag::FIX_TICKS);
+            score->doLayout();
+            QImage pm = score->createThumbnail();
+            delete score;
+            return pm;
             }
+
       Page* page = pages().at(0);
       QRectF fr  = page->abbox();
       qreal mag  = 256.0 / qMax(fr.width(), fr.height());
@@ -495,8 +556,6 @@ QImage Score::createThumbnail()
       p.scale(mag, mag);
       print(&p, 0);
       p.end();
-      if (layoutMode != _layoutMode)
-            endCmd(true);       // rollback
       return pm;
       }
 
@@ -507,7 +566,20 @@ QImage Score::createThumbnail()
 
 void Score::saveCompressedFile(QIODevice* f, QFileInfo& info, bool onlySelection)
       {
-      MQZipWriter uz(f);
+      writeMscz(f, msczSnapshot(info, onlySelection));
+      }
+
+//---------------------------------------------------------
+//   msczSnapshot
+//    collect the contents of a compressed score file
+//    without compressing anything; images are shared with
+//    the score, not copied
+//---------------------------------------------------------
+
+MsczSnapshot Score::msczSnapshot(const QFileInfo& info, bool onlySelection, bool thumbnail)
+      {
+      TRACE_SCOPE("msczSnapshot");
+      MsczSnapshot snapshot;
 
       QString fn = info.completeBaseName() + ".mscx";
       QBuffer cbuf;
@@ -529,7 +601,7 @@ void Score::saveCompressedFile(QIODevice* f, QFileInfo& info, bool onlySelection
       xml.etag();
       cbuf.seek(0);
       //uz.addDirectory("META-INF");
-      uz.addFile("META-INF/container.xml", cbuf.data());
+      snapshot.add("META-INF/container.xml", cbuf.data());
 
       // save images
       //uz.addDirectory("Pictures");
@@ -537,19 +609,12 @@ void Score::saveCompressedFile(QIODevice* f, QFileInfo& info, bool onlySelection
             if (!ip->isUsed(this))
                   continue;
             QString path = QString("Pictures/") + ip->hashName();
-            uz.addFile(path, ip->buffer());
+            snapshot.add(path, ip->buffer());
             }
 
       // create thumbnail
-      QImage pm = createThumbnail();
-
-      QByteArray ba;
-      QBuffer b(&ba);
-      if (!b.open(QIODevice::WriteOnly))
-            qDebug("open buffer failed");
-      if (!pm.save(&b, "PNG"))
-            qDebug("save failed");
-      uz.addFile("Thumbnails/thumbnail.png", ba);
+      if (thumbnail)
+            snapshot.add("Thumbnails/thumbnail.png", createThumbnail());
 
 #ifdef OMR
       //
@@ -559,13 +624,7 @@ void Score::saveCompressedFile(QIODevice* f, QFileInfo& info, bool onlySelection
             int n = _omr->numPages();
             for (int i = 0; i < n; ++i) {
                   QString path = QString("OmrPages/page%1.png").arg(i+1);
-                  QBuffer cbuf;
-                  OmrPage* page = _omr->page(i);
-                  const QImage& image = page->image();
-                  if (!image.save(&cbuf, "PNG"))
-                        throw(QString("save file: cannot save image (%1x%2)").arg(image.width()).arg(image.height()));
-                  uz.addFile(path, cbuf.data());
-                  cbuf.close();
+                  snapshot.add(path, _omr->page(i)->image());
                   }
             }
 #endif
@@ -573,13 +632,37 @@ void Score::saveCompressedFile(QIODevice* f, QFileInfo& info, bool onlySelection
       // save audio
       //
       if (_audio)
-            uz.addFile("audio.ogg", _audio->data());
+            snapshot.add("audio.ogg", _audio->data());
 
       QBuffer dbuf;
       dbuf.open(QIODevice::ReadWrite);
       saveFile(&dbuf, true, onlySelection);
       dbuf.seek(0);
-      uz.addFile(fn, dbuf.data());
+      snapshot.add(fn, dbuf.data());
+      return snapshot;
+      }
+
+//---------------------------------------------------------
+//   writeMscz
+//    compress a snapshot into f; does not touch the score
+//    and may run on any thread
+//---------------------------------------------------------
+
+void Score::writeMscz(QIODevice* f, const MsczSnapshot& snapshot)
+      {
+      TRACE_SCOPE("writeMscz");
+      MQZipWriter uz(f);
+
+      for (const MsczSnapshot::File& file : snapshot.files) {
+            if (file.image.isNull()) {
+                  uz.addFile(file.path, file.data);
+                  continue;
+                  }
+            QBuffer cbuf;
+            if (!file.image.save(&cbuf, "PNG"))
+                  throw(QString("save file: cannot save image (%1x%2)").arg(file.image.width()).arg(file.image.height()));
+            uz.addFile(file.path, cbuf.data());
+            }
       uz.close();
       }
 
@@ -663,6 +746,7 @@ extern bool enableTestMode;
 
 void Score::saveFile(QIODevice* f, bool msczFormat, bool onlySelection)
       {
+      TRACE_SCOPE("saveFile");
       if(!MScore::testMode)
             MScore::testMode = enableTestMode;
       Xml xml(f);
@@ -827,6 +911,7 @@ Score::FileError Score::loadMsc(QString name, bool ignoreVersionError)
 
 Score::FileError Score::loadMsc(QString name, QIODevice* io, bool ignoreVersionError)
       {
+      TRACE_SCOPE("loadMsc");
       info.setFile(name);
 
       if (name.endsWith(".mscz"))
@@ -1486,17 +1571,28 @@ void Score::writeSegments(Xml& xml, int strack, int etrack,
                   segment->write(xml);    // write only once
                   }
             //write spanner ending after the last segment, on the last tick
-            if (clip || ls == 0) {
+            // spanners crossing the end of Score::write(..., end) end here;
+            // slurs and note spanners are cut off by ChordRest::write()
+            // and Note::write()
+            bool cut = endTick == xml.cutTick;
+            if (clip || ls == 0 || cut) {
                   auto endIt = spanner().upper_bound(endTick);
                   for (auto i = spanner().begin(); i != endIt; ++i) {
                         Spanner* s = i->second;
                         if (s->generated() || !xml.canWrite(s))
                               continue;
-                        if ((s->tick2() == endTick)
+                        bool cutOff = cut && xml.cutOff(s);
+                        if (cutOff && s->anchor() == Spanner::Anchor::NOTE)
+                              continue;         // not written by Note::write()
+                        if ((s->tick2() == endTick || cutOff)
                           && s->type() != Element::Type::SLUR
                           && (s->track2() == track || (s->track2() == -1 && s->track() == track))
                           && (!clip || s->tick() >= fs->tick())
                           ) {
+                              if (cut && xml.curTick != endTick) {
+                                    xml.tag("tick", endTick - xml.tickDiff);
+                                    xml.curTick = endTick;
+                                    }
                               xml.tagE(QString("endSpanner id=\"%1\"").arg(xml.spannerId(s)));
                               }
                         }
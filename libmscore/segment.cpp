@@ -75,6 +75,7 @@ const char* Segment::subTypeName(Type t)
 
 void Segment::setElement(int track, Element* el)
       {
+      score()->measures()->invalidateChordRestIndex();
       if (el) {
             el->setParent(this);
             _elist[track] = el;
@@ -163,6 +164,7 @@ void Segment::setSegmentType(Type t)
       {
       Q_ASSERT(_segmentType != Type::Clef || t != Type::ChordRest);
       _segmentType = t;
+      score()->measures()->invalidateChordRestIndex();
       }
 
 //---------------------------------------------------------
@@ -380,7 +382,8 @@ void Segment::insertStaff(int staff)
       int track = staff * VOICES;
       for (int voice = 0; voice < VOICES; ++voice)
             _elist.insert(track, 0);
-      _dotPosX.insert(staff, 0.0);
+      score()->measures()->invalidateChordRestIndex();
+      _dotPosX.insert(_dotPosX.begin() + staff, 0.0);
 
       foreach(Element* e, _annotations) {
             int staffIdx = e->staffIdx();
@@ -398,7 +401,8 @@ void Segment::removeStaff(int staff)
       {
       int track = staff * VOICES;
       _elist.erase(_elist.begin() + track, _elist.begin() + track + VOICES);
-      _dotPosX.removeAt(staff);
+      score()->measures()->invalidateChordRestIndex();
+      _dotPosX.erase(_dotPosX.begin() + staff);
 
       foreach(Element* e, _annotations) {
             int staffIdx = e->staffIdx();
@@ -435,6 +439,8 @@ void Segment::add(Element* el)
       Q_ASSERT(track != -1);
       Q_ASSERT(el->score() == score());
       Q_ASSERT(score()->nstaves() * VOICES == _elist.size());
+      if (el->isChordRest())
+            score()->measures()->invalidateChordRestIndex();
 
       switch (el->type()) {
             case Element::Type::REPEAT_MEASURE:
@@ -557,6 +563,8 @@ void Segment::remove(Element* el)
 // qDebug("%p Segment::remove %s %p", this, el->name(), el);
 
       int track = el->track();
+      if (el->isChordRest())
+            score()->measures()->invalidateChordRestIndex();
 
       switch(el->type()) {
             case Element::Type::CHORD:
@@ -681,6 +689,7 @@ Segment::Type Segment::segmentType(Element::Type type)
 
 void Segment::removeGeneratedElements()
       {
+      score()->measures()->invalidateChordRestIndex();
       for (int i = 0; i < _elist.size(); ++i) {
             if (_elist[i] && _elist[i]->generated()) {
                   _elist[i] = 0;
@@ -704,6 +713,7 @@ void Segment::sortStaves(QList<int>& dst)
                   dl.append(_elist[k]);
             }
       _elist = dl;
+      score()->measures()->invalidateChordRestIndex();
       QMap<int, int> map;
       for (int k = 0; k < dst.size(); ++k) {
             map.insert(dst[k], k);
@@ -764,6 +774,17 @@ int Segment::tick() const
 void Segment::setTick(int t)
       {
       _tick = t - measure()->tick();
+      score()->measures()->invalidateChordRestIndex();
+      }
+
+//---------------------------------------------------------
+//   setRtick
+//---------------------------------------------------------
+
+void Segment::setRtick(int val)
+      {
+      _tick = val;
+      score()->measures()->invalidateChordRestIndex();
       }
 
 //---------------------------------------------------------
@@ -791,6 +812,7 @@ const QList<Lyrics*>* Segment::lyricsList(int track) const
 
 void Segment::swapElements(int i1, int i2)
       {
+      score()->measures()->invalidateChordRestIndex();
       _elist.swap(i1, i2);
       if (_elist[i1])
             _elist[i1]->setTrack(i1);
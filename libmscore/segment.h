@@ -94,7 +94,7 @@ public:
       int _tick;
       Spatium _extraLeadingSpace;
       Spatium _extraTrailingSpace;
-      QList<qreal>   _dotPosX;     ///< size = staves
+      std::vector<qreal> _dotPosX;  ///< size = staves, written by parallel layoutStage3()
 
       std::vector<Element*> _annotations;
       QList<Element*> _qmlAnnotations;
@@ -179,7 +179,7 @@ public:
       void setTick(int);
       int tick() const;
       int rtick() const                          { return _tick; } // tickposition relative to measure start
-      void setRtick(int val)                     { _tick = val; }
+      void setRtick(int val);
 
       bool splitsTuplet() const;
 
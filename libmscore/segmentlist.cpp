@@ -101,6 +101,7 @@ void SegmentList::insert(Segment* e, Segment* el)
       else if (el == first())
             push_front(e);
       else {
+            e->score()->measures()->invalidateChordRestIndex();
             ++_size;
             e->setNext(el);
             e->setPrev(el->prev());
@@ -116,6 +117,7 @@ void SegmentList::insert(Segment* e, Segment* el)
 
 void SegmentList::remove(Segment* el)
       {
+      el->score()->measures()->invalidateChordRestIndex();
       --_size;
       if (el == _first) {
             _first = _first->next();
@@ -142,6 +144,7 @@ void SegmentList::remove(Segment* el)
 
 void SegmentList::push_back(Segment* e)
       {
+      e->score()->measures()->invalidateChordRestIndex();
       ++_size;
       e->setNext(0);
       if (_last)
@@ -159,6 +162,7 @@ void SegmentList::push_back(Segment* e)
 
 void SegmentList::push_front(Segment* e)
       {
+      e->score()->measures()->invalidateChordRestIndex();
       ++_size;
       e->setPrev(0);
       if (_first)
@@ -206,6 +210,7 @@ void SegmentList::insert(Segment* seg)
                   }
             }
 #endif
+      seg->score()->measures()->invalidateChordRestIndex();
       if (seg->prev())
             seg->prev()->setNext(seg);
       else
@@ -12,6 +12,7 @@
 
 #include "style.h"
 #include "sym.h"
+#include "glyphcache.h"
 #include "utils.h"
 #include "score.h"
 #include "xml.h"
@@ -21,7 +22,11 @@
 #include FT_IMAGE_H
 #include FT_BBOX_H
 
+#include <QtCore/QCryptographicHash>
+
 static FT_Library ftlib;
+static QMutex ftMutex;        // FreeType faces are not thread safe; pages may be painted concurrently
+                              // and fonts may be loaded by the first page needing them
 
 namespace Ms {
 
@@ -5266,16 +5271,6 @@ SymId Sym::userName2id(const QString& s)
       return (val == -1) ? SymId::noSym : (SymId)(val);
       }
 
-//---------------------------------------------------------
-//   GlyphKey operator==
-//---------------------------------------------------------
-
-bool GlyphKey::operator==(const GlyphKey& k) const
-      {
-      return (face == k.face) && (id == k.id)
-         && (mag == k.mag) && (worldScale == k.worldScale) && (color == k.color);
-      }
-
 //---------------------------------------------------------
 //   draw
 //---------------------------------------------------------
@@ -5296,17 +5291,14 @@ void ScoreFont::draw(SymId id, QPainter* painter, qreal mag, const QPointF& pos,
             qDebug("ScoreFont::draw: invalid sym %d\n", int(id));
             return;
             }
-      int rv = FT_Load_Glyph(face, sym(id).index(), FT_LOAD_DEFAULT);
-      if (rv) {
-            qDebug("load glyph id %d, failed: 0x%x", int(id), rv);
-            return;
-            }
 
       if (MScore::pdfPrinting) {
+            ftMutex.lock();
             if (font == 0) {
                   QString s(_fontPath+_filename);
                   if (-1 == QFontDatabase::addApplicationFont(s)) {
                         qDebug("Mscore: fatal error: cannot load internal font <%s>", qPrintable(s));
+                        ftMutex.unlock();
                         return;
                         }
                   font = new QFont;
@@ -5318,6 +5310,7 @@ void ScoreFont::draw(SymId id, QPainter* painter, qreal mag, const QPointF& pos,
                   qreal size = 20.0 * MScore::DPI / PPI;
                   font->setPixelSize(lrint(size));
                   }
+            ftMutex.unlock();
             qreal imag = 1.0 / mag;
             painter->scale(mag, mag);
             painter->setFont(*font);
@@ -5335,51 +5328,36 @@ void ScoreFont::draw(SymId id, QPainter* painter, qreal mag, const QPointF& pos,
 //            worldScale = 1.0;
       int scale16      = lrint(worldScale * 6553.6 * mag);
 
-      GlyphKey gk(face, id, mag, worldScale, color);
-      GlyphPixmap* pm = cache->object(gk);
-      if (!pm) {
-            FT_Matrix matrix {
-                  scale16, 0,
-                  0,       scale16
-                  };
-
-            FT_Glyph glyph;
-            FT_Get_Glyph(face->glyph, &glyph);
-            FT_Glyph_Transform(glyph, &matrix, 0);
-            rv = FT_Glyph_To_Bitmap(&glyph, FT_RENDER_MODE_NORMAL, 0, 1);
-            if (rv) {
-                  qDebug("glyph to bitmap failed: 0x%x", rv);
-                  return;
-                  }
-
-            FT_BitmapGlyph gb = (FT_BitmapGlyph)glyph;
-            FT_Bitmap* bm     = &gb->bitmap;
+      GlyphKey gk(face, sym(id).index(), scale16);
+      GlyphCache* cache = GlyphCache::instance();
+      if (cache->draw(painter, gk, pos, worldScale, color))
+            return;
 
-            if (bm->width == 0 || bm->rows == 0) {
-                  qDebug("zero glyph");
-                  return;
-                  }
-            QImage img(QSize(bm->width, bm->rows), QImage::Format_ARGB32);
-            img.fill(Qt::transparent);
+      QMutexLocker lock(&ftMutex);
+      int rv = FT_Load_Glyph(face, sym(id).index(), FT_LOAD_DEFAULT);
+      if (rv) {
+            qDebug("load glyph id %d, failed: 0x%x", int(id), rv);
+            return;
+            }
+      FT_Matrix matrix {
+            scale16, 0,
+            0,       scale16
+            };
 
-            for (int y = 0; y < int(bm->rows); ++y) {
-                  unsigned* dst      = (unsigned*)img.scanLine(y);
-                  unsigned char* src = (unsigned char*)(bm->buffer) + bm->pitch * y;
-                  for (int x = 0; x < int(bm->width); ++x) {
-                        unsigned val = *src++;
-                        color.setAlpha(val);
-                        *dst++ = color.rgba();
-                        }
-                  }
-            pm = new GlyphPixmap;
-            pm->pm = QPixmap::fromImage(img, Qt::NoFormatConversion);
-            pm->pm.setDevicePixelRatio(worldScale);
-            pm->offset = QPointF(qreal(gb->left), -qreal(gb->top)) / worldScale;
-            if (!cache->insert(gk, pm))
-                  qDebug("cannot cache glyph");
+      FT_Glyph glyph;
+      FT_Get_Glyph(face->glyph, &glyph);
+      FT_Glyph_Transform(glyph, &matrix, 0);
+      rv = FT_Glyph_To_Bitmap(&glyph, FT_RENDER_MODE_NORMAL, 0, 1);
+      if (rv) {
+            qDebug("glyph to bitmap failed: 0x%x", rv);
             FT_Done_Glyph(glyph);
+            return;
             }
-      painter->drawPixmap(pos + pm->offset, pm->pm);
+      FT_BitmapGlyph gb = (FT_BitmapGlyph)glyph;
+      cache->insert(gk, &gb->bitmap, gb->left, gb->top);
+      FT_Done_Glyph(glyph);
+      lock.unlock();
+      cache->draw(painter, gk, pos, worldScale, color, false);
       }
 
 void ScoreFont::draw(SymId id, QPainter* painter, qreal mag, const QPointF& pos, int n) const
@@ -5483,35 +5461,17 @@ void ScoreFont::computeMetrics(Sym* sym, int code)
       }
 
 //---------------------------------------------------------
-//   load
+//   parseMetrics
+//    compute the symbol metrics from the SMuFL glyph names
+//    and metadata and from the glyph outlines
 //---------------------------------------------------------
 
-void ScoreFont::load()
+void ScoreFont::parseMetrics(const QByteArray& glyphNames, const QByteArray& metadata)
       {
-      QString facePath = _fontPath + _filename;
-      QFile f(facePath);
-      if (!f.open(QIODevice::ReadOnly)) {
-            qDebug("ScoreFont::load(): open failed <%s>", qPrintable(facePath));
-            return;
-            }
-      fontImage = f.readAll();
-      int rval = FT_New_Memory_Face(ftlib, (FT_Byte*)fontImage.data(), fontImage.size(), 0, &face);
-      if (rval) {
-            qDebug("freetype: cannot create face <%s>: %d", qPrintable(facePath), rval);
-            return;
-            }
-      cache = new QCache<GlyphKey, GlyphPixmap>(100);
-
-      qreal pixelSize = 200.0 * MScore::DPI/PPI;
-      FT_Set_Pixel_Sizes(face, 0, int(pixelSize+.5));
-
-      QFile fi(_fontPath + "glyphnames.json");
-      if (!fi.open(QIODevice::ReadOnly))
-            qDebug("ScoreFont: open glyph names file <%s> failed", qPrintable(fi.fileName()));
       QJsonParseError error;
-      QJsonObject o = QJsonDocument::fromJson(fi.readAll(), &error).object();
+      QJsonObject o = QJsonDocument::fromJson(glyphNames, &error).object();
       if (error.error != QJsonParseError::NoError)
-            qDebug("Json parse error in <%s>(offset: %d): %s", qPrintable(fi.fileName()),
+            qDebug("Json parse error in <%sglyphnames.json>(offset: %d): %s", qPrintable(_fontPath),
                error.offset, qPrintable(error.errorString()));
 
       for (auto i : o.keys()) {
@@ -5527,13 +5487,9 @@ void ScoreFont::load()
             //else
             //      qDebug("unknown glyph: %s", qPrintable(i));
             }
-      fi.close();
-      fi.setFileName(_fontPath + "metadata.json");
-      if (!fi.open(QIODevice::ReadOnly))
-            qDebug("ScoreFont: open glyph metadata file <%s> failed", qPrintable(fi.fileName()));
-      o = QJsonDocument::fromJson(fi.readAll(), &error).object();
+      o = QJsonDocument::fromJson(metadata, &error).object();
       if (error.error != QJsonParseError::NoError)
-            qDebug("Json parse error in <%s>(offset: %d): %s", qPrintable(fi.fileName()),
+            qDebug("Json parse error in <%smetadata.json>(offset: %d): %s", qPrintable(_fontPath),
                error.offset, qPrintable(error.errorString()));
 
       QJsonObject oo = o.value("glyphsWithAnchors").toObject();
@@ -5544,7 +5500,7 @@ void ScoreFont::load()
             if (symId == SymId::noSym) {
                   // currently, Bravura contains a bunch of entries in glyphsWithAnchors
                   // for glyph names that will not be found - flag32ndUpStraight, etc.
-                  //qDebug("ScoreFont: symId not found <%s> in <%s>", qPrintable(i), qPrintable(fi.fileName()));
+                  //qDebug("ScoreFont: symId not found <%s> in <%s>", qPrintable(i), qPrintable(_fontPath));
                   continue;
                   }
             Sym* sym = &_symbols[int(symId)];
@@ -5582,6 +5538,257 @@ void ScoreFont::load()
                   }
             }
 
+      // access needed stylistic alternates
+
+      struct StylisticAlternate {
+            QString     key;
+            QString     altKey;
+            SymId       id;
+            }
+      alternate[] = {
+                  {     QString("6stringTabClef"),
+                        QString("6stringTabClefSerif"),
+                        SymId::sixStringTabClefSerif
+                  },
+                  {     QString("noteheadBlack"),
+                        QString("noteheadBlackOversized"),
+                        SymId::noteheadBlack
+                  },
+                  {     QString("noteheadHalf"),
+                        QString("noteheadHalfOversized"),
+                        SymId::noteheadHalf
+                  },
+                  {     QString("noteheadWhole"),
+                        QString("noteheadWholeOversized"),
+                        SymId::noteheadWhole
+                  },
+                  {     QString("noteheadDoubleWhole"),
+                        QString("noteheadDoubleWholeOversized"),
+                        SymId::noteheadDoubleWhole
+                  },
+                  {     QString("noteheadDoubleWholeSquare"),
+                        QString("noteheadDoubleWholeSquareOversized"),
+                        SymId::noteheadDoubleWholeSquare
+                  },
+                  {     QString("noteheadDoubleWhole"),
+                        QString("noteheadDoubleWholeAlt"),
+                        SymId::noteheadDoubleWholeAlt
+                  }
+            };
+
+      // find each relevant alternate in "glyphsWithAlternates" value
+      QJsonObject oa = o.value("glyphsWithAlternates").toObject();
+      bool ok;
+      for (const StylisticAlternate& c : alternate) {
+            QJsonObject::const_iterator i = oa.find(c.key);
+            if (i != oa.end()) {
+                  QJsonArray oaa = i.value().toObject().value("alternates").toArray();
+                  // locate the relevant altKey in alternate array
+                  for (auto j : oaa) {
+                        QJsonObject jo = j.toObject();
+                        if (jo.value("name") == c.altKey) {
+                              Sym* sym = &_symbols[int(c.id)];
+                              int code = jo.value("codepoint").toString().mid(2).toInt(&ok, 16);
+                              if (ok)
+                                    computeMetrics(sym, code);
+                              break;
+                              }
+                        }
+                  }
+            }
+
+      // add space symbol
+      Sym* sym = &_symbols[int(SymId::space)];
+      computeMetrics(sym, 32);
+      }
+
+//---------------------------------------------------------
+//   MetricsHeader
+//    The metrics cache of a font is a header followed by
+//    one MetricsRecord per symbol. It is only valid for
+//    the font and SMuFL files it was computed from and is
+//    read by mapping the file.
+//---------------------------------------------------------
+
+static const char METRICS_MAGIC[4] = { 'M', 'S', 'S', 'M' };
+static const quint32 METRICS_VERSION = 1;
+
+struct MetricsHeader {
+      char magic[4];
+      quint32 version;
+      quint32 symbols;        // int(SymId::lastSym) + 1
+      quint32 hashSize;
+      char hash[32];          // of font, glyphnames.json and metadata.json
+      double dpi;
+      };
+
+struct MetricsRecord {
+      qint32 code;
+      quint32 index;
+      double bbox[4];
+      double advance;
+      double anchors[12];     // stemDownNW, stemUpSE, cutOutNE, cutOutNW, cutOutSE, cutOutSW
+      };
+
+//---------------------------------------------------------
+//   metricsCachePath
+//---------------------------------------------------------
+
+QString ScoreFont::metricsCachePath() const
+      {
+      QString dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+      if (dir.isEmpty())
+            return QString();
+      return dir + "/fonts/" + _name + ".metrics";
+      }
+
+//---------------------------------------------------------
+//   readMetricsCache
+//    return false if there is no valid cache for hash
+//---------------------------------------------------------
+
+bool ScoreFont::readMetricsCache(const QByteArray& hash)
+      {
+      QString path = metricsCachePath();
+      if (path.isEmpty())
+            return false;
+      QFile f(path);
+      int n = int(SymId::lastSym) + 1;
+      qint64 size = sizeof(MetricsHeader) + qint64(n) * sizeof(MetricsRecord);
+      if (!f.open(QIODevice::ReadOnly) || f.size() != size)
+            return false;
+      const uchar* p = f.map(0, size);
+      if (!p)
+            return false;
+      MetricsHeader h;
+      memcpy(&h, p, sizeof(h));
+      if (memcmp(h.magic, METRICS_MAGIC, sizeof(h.magic)) || h.version != METRICS_VERSION
+         || h.symbols != quint32(n) || h.hashSize != quint32(hash.size()) || hash.size() > int(sizeof(h.hash))
+         || memcmp(h.hash, hash.constData(), hash.size()) || h.dpi != MScore::DPI) {
+            f.unmap(const_cast<uchar*>(p));
+            return false;
+            }
+      const uchar* rp = p + sizeof(MetricsHeader);
+      for (int i = 0; i < n; ++i) {
+            MetricsRecord r;
+            memcpy(&r, rp + i * sizeof(MetricsRecord), sizeof(r));
+            if (r.code == -1)
+                  continue;
+            Sym* sym = &_symbols[i];
+            sym->setCode(r.code);
+            sym->setIndex(r.index);
+            sym->setBbox(QRectF(r.bbox[0], r.bbox[1], r.bbox[2], r.bbox[3]));
+            sym->setAdvance(r.advance);
+            sym->setStemDownNW(QPointF(r.anchors[0], r.anchors[1]));
+            sym->setStemUpSE(QPointF(r.anchors[2], r.anchors[3]));
+            sym->setCutOutNE(QPointF(r.anchors[4], r.anchors[5]));
+            sym->setCutOutNW(QPointF(r.anchors[6], r.anchors[7]));
+            sym->setCutOutSE(QPointF(r.anchors[8], r.anchors[9]));
+            sym->setCutOutSW(QPointF(r.anchors[10], r.anchors[11]));
+            }
+      f.unmap(const_cast<uchar*>(p));
+      return true;
+      }
+
+//---------------------------------------------------------
+//   writeMetricsCache
+//---------------------------------------------------------
+
+void ScoreFont::writeMetricsCache(const QByteArray& hash) const
+      {
+      QString path = metricsCachePath();
+      if (path.isEmpty() || hash.size() > int(sizeof(MetricsHeader::hash)))
+            return;
+      QDir().mkpath(QFileInfo(path).absolutePath());
+      QSaveFile f(path);
+      if (!f.open(QIODevice::WriteOnly)) {
+            qDebug("ScoreFont: cannot write metrics cache <%s>", qPrintable(path));
+            return;
+            }
+      MetricsHeader h;
+      memset(&h, 0, sizeof(h));
+      memcpy(h.magic, METRICS_MAGIC, sizeof(h.magic));
+      h.version  = METRICS_VERSION;
+      h.symbols  = _symbols.size();
+      h.hashSize = hash.size();
+      memcpy(h.hash, hash.constData(), hash.size());
+      h.dpi      = MScore::DPI;
+      f.write(reinterpret_cast<const char*>(&h), sizeof(h));
+      for (const Sym& sym : _symbols) {
+            MetricsRecord r;
+            memset(&r, 0, sizeof(r));
+            r.code = sym.isValid() ? sym.code() : -1;
+            if (sym.isValid()) {
+                  QRectF bb = sym.bbox();
+                  QPointF a[6] = { sym.stemDownNW(), sym.stemUpSE(), sym.cutOutNE(),
+                                   sym.cutOutNW(), sym.cutOutSE(), sym.cutOutSW() };
+                  r.index   = sym.index();
+                  r.bbox[0] = bb.x();
+                  r.bbox[1] = bb.y();
+                  r.bbox[2] = bb.width();
+                  r.bbox[3] = bb.height();
+                  r.advance = sym.advance();
+                  for (int i = 0; i < 6; ++i) {
+                        r.anchors[i * 2]     = a[i].x();
+                        r.anchors[i * 2 + 1] = a[i].y();
+                        }
+                  }
+            f.write(reinterpret_cast<const char*>(&r), sizeof(r));
+            }
+      if (!f.commit())
+            qDebug("ScoreFont: cannot write metrics cache <%s>", qPrintable(path));
+      }
+
+//---------------------------------------------------------
+//   readFontFile
+//---------------------------------------------------------
+
+static QByteArray readFontFile(const QString& path)
+      {
+      QFile f(path);
+      if (!f.open(QIODevice::ReadOnly)) {
+            qDebug("ScoreFont: open file <%s> failed", qPrintable(path));
+            return QByteArray();
+            }
+      return f.readAll();
+      }
+
+//---------------------------------------------------------
+//   load
+//    the symbol metrics are read from the metrics cache
+//    if it was computed from the same files
+//---------------------------------------------------------
+
+void ScoreFont::load()
+      {
+      QString facePath = _fontPath + _filename;
+      QFile f(facePath);
+      if (!f.open(QIODevice::ReadOnly)) {
+            qDebug("ScoreFont::load(): open failed <%s>", qPrintable(facePath));
+            return;
+            }
+      fontImage = f.readAll();
+      int rval = FT_New_Memory_Face(ftlib, (FT_Byte*)fontImage.data(), fontImage.size(), 0, &face);
+      if (rval) {
+            qDebug("freetype: cannot create face <%s>: %d", qPrintable(facePath), rval);
+            return;
+            }
+
+      qreal pixelSize = 200.0 * MScore::DPI/PPI;
+      FT_Set_Pixel_Sizes(face, 0, int(pixelSize+.5));
+
+      QByteArray glyphNames = readFontFile(_fontPath + "glyphnames.json");
+      QByteArray metadata   = readFontFile(_fontPath + "metadata.json");
+      QCryptographicHash h(QCryptographicHash::Sha1);
+      h.addData(fontImage);
+      h.addData(glyphNames);
+      h.addData(metadata);
+      QByteArray hash = h.result();
+      if (!readMetricsCache(hash)) {
+            parseMetrics(glyphNames, metadata);
+            writeMetricsCache(hash);
+            }
+
       // create missing composed glyphs
 
       struct Composed {
@@ -5660,69 +5867,6 @@ void ScoreFont::load()
                   }
             }
 
-      // access needed stylistic alternates
-
-      struct StylisticAlternate {
-            QString     key;
-            QString     altKey;
-            SymId       id;
-            }
-      alternate[] = {
-                  {     QString("6stringTabClef"),
-                        QString("6stringTabClefSerif"),
-                        SymId::sixStringTabClefSerif
-                  },
-                  {     QString("noteheadBlack"),
-                        QString("noteheadBlackOversized"),
-                        SymId::noteheadBlack
-                  },
-                  {     QString("noteheadHalf"),
-                        QString("noteheadHalfOversized"),
-                        SymId::noteheadHalf
-                  },
-                  {     QString("noteheadWhole"),
-                        QString("noteheadWholeOversized"),
-                        SymId::noteheadWhole
-                  },
-                  {     QString("noteheadDoubleWhole"),
-                        QString("noteheadDoubleWholeOversized"),
-                        SymId::noteheadDoubleWhole
-                  },
-                  {     QString("noteheadDoubleWholeSquare"),
-                        QString("noteheadDoubleWholeSquareOversized"),
-                        SymId::noteheadDoubleWholeSquare
-                  },
-                  {     QString("noteheadDoubleWhole"),
-                        QString("noteheadDoubleWholeAlt"),
-                        SymId::noteheadDoubleWholeAlt
-                  }
-            };
-
-      // find each relevant alternate in "glyphsWithAlternates" value
-      QJsonObject oa = o.value("glyphsWithAlternates").toObject();
-      bool ok;
-      for (const StylisticAlternate& c : alternate) {
-            QJsonObject::const_iterator i = oa.find(c.key);
-            if (i != oa.end()) {
-                  QJsonArray oaa = i.value().toObject().value("alternates").toArray();
-                  // locate the relevant altKey in alternate array
-                  for (auto j : oaa) {
-                        QJsonObject jo = j.toObject();
-                        if (jo.value("name") == c.altKey) {
-                              Sym* sym = &_symbols[int(c.id)];
-                              int code = jo.value("codepoint").toString().mid(2).toInt(&ok, 16);
-                              if (ok)
-                                    computeMetrics(sym, code);
-                              break;
-                              }
-                        }
-                  }
-            }
-
-      // add space symbol
-      Sym* sym = &_symbols[int(SymId::space)];
-      computeMetrics(sym, 32);
-
       /*for (int i = 1; i < int(SymId::lastSym); ++i) {
             Sym sym = _symbols[i];
             if (!sym.isValid())
@@ -5745,6 +5889,7 @@ ScoreFont* ScoreFont::fontFactory(QString s)
             }
       Q_ASSERT(f);
 
+      QMutexLocker lock(&ftMutex);
       if (!f->face)
             f->load();
       return f;
@@ -5757,6 +5902,7 @@ ScoreFont* ScoreFont::fontFactory(QString s)
 ScoreFont* ScoreFont::fallbackFont()
       {
       ScoreFont* f = &_scoreFonts[FALLBACK_FONT];
+      QMutexLocker lock(&ftMutex);
       if (!f->face)
             f->load();
       return f;
@@ -5811,12 +5957,12 @@ ScoreFont::ScoreFont(const ScoreFont& f)
       _filename = f._filename;
 
       // fontImage;
-      cache = 0;
       }
 
 ScoreFont::~ScoreFont()
       {
-      delete cache;
+      if (face)
+            GlyphCache::instance()->remove(face);
       }
 }
 
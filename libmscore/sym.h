@@ -2575,34 +2575,6 @@ class Sym {
       friend class ScoreFont;
       };
 
-//---------------------------------------------------------
-//   GlyphKey
-//---------------------------------------------------------
-
-struct GlyphKey {
-      FT_Face face;
-      SymId id;
-      qreal mag;
-      qreal worldScale;
-      QColor color;
-
-   public:
-      GlyphKey(FT_Face _f, SymId _id, float m, float s, QColor c)
-         : face(_f), id(_id), mag(m), worldScale(s), color(c) {}
-      bool operator==(const GlyphKey&) const;
-      };
-
-
-struct GlyphPixmap {
-      QPixmap pm;
-      QPointF offset;
-      };
-
-inline uint qHash(const GlyphKey& k)
-      {
-      return (int(k.id) << 16) + k.mag;
-      }
-
 //---------------------------------------------------------
 //   ScoreFont
 //---------------------------------------------------------
@@ -2615,13 +2587,16 @@ class ScoreFont {
       QString _fontPath;
       QString _filename;
       QByteArray fontImage;
-      QCache<GlyphKey, GlyphPixmap>* cache { 0 };
       mutable QFont* font { 0 };
 
       static QVector<ScoreFont> _scoreFonts;
       const Sym& sym(SymId id) const { return _symbols[int(id)]; }
       void load();
       void computeMetrics(Sym* sym, int code);
+      void parseMetrics(const QByteArray& glyphNames, const QByteArray& metadata);
+      QString metricsCachePath() const;
+      bool readMetricsCache(const QByteArray& hash);
+      void writeMetricsCache(const QByteArray& hash) const;
 
    public:
       ScoreFont() {}
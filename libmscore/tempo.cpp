@@ -101,6 +101,8 @@ void TempoMap::normalize()
       qreal time  = 0;
       int tick    = 0;
       qreal tempo = 2.0;
+      _timeIndex.clear();
+      _timeIndex.reserve(size());
       for (auto e = begin(); e != end(); ++e) {
             // entries that represent a pause *only* (not tempo change also)
             // need to be corrected to continue previous tempo
@@ -110,6 +112,7 @@ void TempoMap::normalize()
             time += qreal(delta) / (MScore::division * tempo * _relTempo);
             time += e->second.pause;
             e->second.time = time;
+            _timeIndex.push_back(std::make_pair(time, e->first));
             tick  = e->first;
             tempo = e->second.tempo;
             }
@@ -135,6 +138,7 @@ void TempoMap::dump() const
 void TempoMap::clear()
       {
       std::map<int,TEvent>::clear();
+      _timeIndex.clear();
       ++_tempoSN;
       }
 
@@ -266,23 +270,24 @@ qreal TempoMap::tick2time(int tick, int* sn) const
 
 int TempoMap::time2tick(qreal time, int* sn) const
       {
-      int tick     = 0;
-      qreal delta = time;
-      qreal tempo = _tempo;
+      int tick    = 0;
+      qreal delta = 0.0;
+      qreal tempo = 2.0;
 
-      delta = 0.0;
-      tempo = 2.0;
-      for (auto e = begin(); e != end(); ++e) {
+      // first event at or after time
+      auto i = std::lower_bound(_timeIndex.begin(), _timeIndex.end(), time,
+         [](const std::pair<qreal, int>& p, qreal t) { return p.first < t; });
+      if (i != _timeIndex.begin()) {
+            auto pe = find((i - 1)->second);
+            delta = pe->second.time;
+            tick  = pe->first;
+            tempo = pe->second.tempo;
+            }
+      if (i != _timeIndex.end()) {
             // if in a pause period, wait on previous tick
-            if ((time <= e->second.time) && (time > e->second.time - e->second.pause)) {
-                  delta = (time - (e->second.time - e->second.pause) + delta);
-                  break;
-                  }
-            if (e->second.time >= time)
-                  break;
-            delta = e->second.time;
-            tick  = e->first;
-            tempo = e->second.tempo;
+            const TEvent& e = find(i->second)->second;
+            if (time > e.time - e.pause)
+                  delta = (time - (e.time - e.pause) + delta);
             }
       delta = time - delta;
       tick += lrint(delta * _relTempo * MScore::division * tempo);
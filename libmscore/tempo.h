@@ -46,6 +46,7 @@ class TempoMap : public std::map<int, TEvent> {
       int _tempoSN;           // serial no to track tempo changes
       qreal _tempo;           // tempo if not using tempo list (beats per second)
       qreal _relTempo;        // rel. tempo
+      std::vector<std::pair<qreal, int>> _timeIndex;  // (time, tick) of every event, for time2tick()
 
       void normalize();
       void del(int tick);
@@ -0,0 +1,105 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2015 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include "trace.h"
+
+namespace Ms {
+
+static const int MAX_EVENTS = 4 * 1024 * 1024;  // stop recording after this
+
+//---------------------------------------------------------
+//   TraceEvent
+//---------------------------------------------------------
+
+struct TraceEvent {
+      const char* name;
+      qint64 start;
+      qint64 duration;
+      quintptr thread;
+      };
+
+std::atomic<bool> Trace::_enabled { false };
+
+static QString tracePath;
+static QElapsedTimer traceClock;
+static QMutex traceMutex;
+static std::vector<TraceEvent> traceEvents;
+
+//---------------------------------------------------------
+//   start
+//    record events until stop(), which writes them to path
+//---------------------------------------------------------
+
+void Trace::start(const QString& path)
+      {
+      QMutexLocker locker(&traceMutex);
+      tracePath = path;
+      traceEvents.clear();
+      traceEvents.reserve(64 * 1024);
+      traceClock.start();
+      _enabled = true;
+      }
+
+//---------------------------------------------------------
+//   now
+//---------------------------------------------------------
+
+qint64 Trace::now()
+      {
+      return traceClock.nsecsElapsed() / 1000;
+      }
+
+//---------------------------------------------------------
+//   add
+//---------------------------------------------------------
+
+void Trace::add(const char* name, qint64 start, qint64 duration)
+      {
+      TraceEvent e { name, start, duration, quintptr(QThread::currentThreadId()) };
+      QMutexLocker locker(&traceMutex);
+      if (!_enabled || traceEvents.size() >= MAX_EVENTS)
+            return;
+      traceEvents.push_back(e);
+      }
+
+//---------------------------------------------------------
+//   stop
+//    write all events as Chrome trace event json
+//---------------------------------------------------------
+
+void Trace::stop()
+      {
+      if (!_enabled)
+            return;
+      _enabled = false;
+      QMutexLocker locker(&traceMutex);
+      QFile f(tracePath);
+      if (!f.open(QIODevice::WriteOnly)) {
+            qDebug("cannot write trace file <%s>", qPrintable(tracePath));
+            return;
+            }
+      QTextStream ts(&f);
+      ts << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+      for (size_t i = 0; i < traceEvents.size(); ++i) {
+            const TraceEvent& e = traceEvents[i];
+            ts << "{\"name\":\"" << e.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << e.thread
+               << ",\"ts\":" << e.start << ",\"dur\":" << e.duration << "}"
+               << (i + 1 < traceEvents.size() ? ",\n" : "\n");
+            }
+      ts << "]}\n";
+      if (traceEvents.size() >= size_t(MAX_EVENTS))
+            qDebug("trace: event limit reached, later events were dropped");
+      traceEvents.clear();
+      }
+
+}
+
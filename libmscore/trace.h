@@ -0,0 +1,72 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2015 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __TRACE_H__
+#define __TRACE_H__
+
+#include <atomic>
+#include "config.h"
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   Trace
+//    Collects nested timings of named scopes and writes
+//    them as Chrome trace events (chrome://tracing).
+//    Nothing is recorded until start() is called; then a
+//    scope costs two clock reads and a locked append.
+//---------------------------------------------------------
+
+class Trace {
+      static std::atomic<bool> _enabled;
+
+   public:
+      static bool enabled()   { return _enabled; }
+      static void start(const QString& path);
+      static void stop();
+      static qint64 now();    // microseconds since start()
+      static void add(const char* name, qint64 start, qint64 duration);
+      };
+
+//---------------------------------------------------------
+//   TraceScope
+//    records the time from construction to end() or
+//    destruction
+//---------------------------------------------------------
+
+class TraceScope {
+      const char* _name;
+      qint64 _start;
+
+   public:
+      TraceScope(const char* name) : _name(name), _start(Trace::enabled() ? Trace::now() : -1) {}
+      ~TraceScope() { end(); }
+      void end() {
+            if (_start >= 0)
+                  Trace::add(_name, _start, Trace::now() - _start);
+            _start = -1;
+            }
+      };
+
+#ifdef USE_TRACE
+#define TRACE_SCOPE(name)     Ms::TraceScope traceScope__(name)
+#define TRACE_BEGIN(id, name) Ms::TraceScope id(name)
+#define TRACE_END(id)         id.end()
+#else
+#define TRACE_SCOPE(name)
+#define TRACE_BEGIN(id, name)
+#define TRACE_END(id)
+#endif
+
+}     // namespace Ms
+#endif
+
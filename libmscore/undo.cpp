@@ -111,6 +111,38 @@ void updateNoteLines(Segment* segment, int track)
             }
       }
 
+//---------------------------------------------------------
+//   addElementTickRange
+//    extend stick - etick by the measure containing e;
+//    returns false if the element can affect the layout
+//    outside of its measure
+//---------------------------------------------------------
+
+static bool addElementTickRange(Element* e, int* stick, int* etick)
+      {
+      switch (e->type()) {
+            case Element::Type::NOTE:
+            case Element::Type::CHORD:
+            case Element::Type::REST:
+            case Element::Type::SEGMENT:
+            case Element::Type::ACCIDENTAL:
+            case Element::Type::ARTICULATION:
+            case Element::Type::FINGERING:
+                  break;
+            default:
+                  return false;
+            }
+      Element* m = e->findMeasure();
+      if (!m)
+            return false;
+      Measure* measure = static_cast<Measure*>(m);
+      if (*stick == -1 || measure->tick() < *stick)
+            *stick = measure->tick();
+      if (*etick == -1 || measure->endTick() > *etick)
+            *etick = measure->endTick();
+      return true;
+      }
+
 //---------------------------------------------------------
 //   UndoCommand
 //---------------------------------------------------------
@@ -131,6 +163,24 @@ void UndoCommand::cleanup(bool undo)
             c->cleanup(undo);
       }
 
+//---------------------------------------------------------
+//   UndoCommand::tickRange
+//    Compute the tick range touched by this command and
+//    its children. Returns false if the command may affect
+//    the layout of the whole score.
+//---------------------------------------------------------
+
+bool UndoCommand::tickRange(int* stick, int* etick) const
+      {
+      if (childList.isEmpty())
+            return false;
+      for (auto c : childList) {
+            if (!c->tickRange(stick, etick))
+                  return false;
+            }
+      return true;
+      }
+
 //---------------------------------------------------------
 //   undo
 //---------------------------------------------------------
@@ -1495,6 +1545,15 @@ void AddElement::cleanup(bool undo)
             }
       }
 
+//---------------------------------------------------------
+//   AddElement::tickRange
+//---------------------------------------------------------
+
+bool AddElement::tickRange(int* stick, int* etick) const
+      {
+      return addElementTickRange(element, stick, etick);
+      }
+
 //---------------------------------------------------------
 //   undoRemoveTuplet
 //---------------------------------------------------------
@@ -1658,6 +1717,15 @@ void RemoveElement::cleanup(bool undo)
             }
       }
 
+//---------------------------------------------------------
+//   RemoveElement::tickRange
+//---------------------------------------------------------
+
+bool RemoveElement::tickRange(int* stick, int* etick) const
+      {
+      return addElementTickRange(element, stick, etick);
+      }
+
 //---------------------------------------------------------
 //   undo
 //---------------------------------------------------------
@@ -1915,6 +1983,11 @@ void ChangePitch::flip()
       note->score()->setLayoutAll(true);
       }
 
+bool ChangePitch::tickRange(int* stick, int* etick) const
+      {
+      return addElementTickRange(note, stick, etick);
+      }
+
 //---------------------------------------------------------
 //   ChangeFretting
 //
@@ -109,6 +109,7 @@ class UndoCommand {
       int childCount() const             { return childList.size();     }
       void unwind();
       virtual void cleanup(bool undo);
+      virtual bool tickRange(int* stick, int* etick) const;
 #ifdef DEBUG_UNDO
       virtual const char* name() const  { return "UndoCommand"; }
 #endif
@@ -159,6 +160,7 @@ class SaveState : public UndoCommand {
       SaveState(Score*);
       virtual void undo();
       virtual void redo();
+      virtual bool tickRange(int*, int*) const { return true; }
       UNDO_NAME("SaveState")
       };
 
@@ -315,6 +317,7 @@ class ChangePitch : public UndoCommand {
 
    public:
       ChangePitch(Note* note, int pitch, int tpc1, int tpc2);
+      virtual bool tickRange(int* stick, int* etick) const;
       UNDO_NAME("ChangePitch")
       };
 
@@ -573,6 +576,7 @@ class AddElement : public UndoCommand {
       virtual void undo();
       virtual void redo();
       virtual void cleanup(bool);
+      virtual bool tickRange(int* stick, int* etick) const;
 #ifdef DEBUG_UNDO
       virtual const char* name() const;
 #endif
@@ -590,6 +594,7 @@ class RemoveElement : public UndoCommand {
       virtual void undo();
       virtual void redo();
       virtual void cleanup(bool);
+      virtual bool tickRange(int* stick, int* etick) const;
 #ifdef DEBUG_UNDO
       virtual const char* name() const;
 #endif
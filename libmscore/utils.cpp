@@ -47,10 +47,22 @@ Measure* Score::tick2measure(int tick) const
             return lastMeasure();
       Measure* lm = 0;
 
-      for (Measure* m = firstMeasure(); m; m = m->nextMeasure()) {
-            if (tick < m->tick())
-                  return lm;
-            lm = m;
+      const QVector<Measure*>* index = _measures.measureIndex();
+      if (index) {
+            auto i = std::upper_bound(index->begin(), index->end(), tick,
+               [](int t, const Measure* m) { return t < m->tick(); });
+            if (i == index->begin())
+                  return 0;
+            if (i != index->end())
+                  return *(i - 1);
+            lm = index->last();
+            }
+      else {
+            for (Measure* m = firstMeasure(); m; m = m->nextMeasure()) {
+                  if (tick < m->tick())
+                        return lm;
+                  lm = m;
+                  }
             }
       // check last measure
       if (lm && (tick >= lm->tick()) && (tick <= lm->endTick()))
@@ -61,14 +73,31 @@ Measure* Score::tick2measure(int tick) const
 
 //---------------------------------------------------------
 //   tick2measureMM
+//    The measure at tick is found with tick2measure(), if
+//    it is covered by a multi measure rest, the mm rest is
+//    returned.
 //---------------------------------------------------------
 
 Measure* Score::tick2measureMM(int tick) const
       {
       if (tick == -1)
             return lastMeasureMM();
-      Measure* lm = 0;
+      if (!styleB(StyleIdx::createMultiMeasureRests))
+            return tick2measure(tick);
+
+      Measure* m = tick2measure(tick);
+      if (m) {
+            Measure* sm = m;
+            while (sm && sm->mmRestCount() < 0)
+                  sm = sm->prevMeasure();
+            if (sm == m && !m->hasMMRest())
+                  return m;
+            if (sm && sm->hasMMRest() && tick <= sm->mmRest()->endTick())
+                  return sm->mmRest();
+            }
 
+      // mm rests are not up to date, search the measure list
+      Measure* lm = 0;
       for (Measure* m = firstMeasureMM(); m; m = m->nextMeasureMM()) {
             if (tick < m->tick())
                   return lm;
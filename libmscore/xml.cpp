@@ -866,5 +866,17 @@ bool Xml::canWriteVoice(int track) const
       return _filter.canSelectVoice(track);
       }
 
+//---------------------------------------------------------
+//   cutOff
+//    true if s starts before cutTick but does not end
+//    before it; such spanners are written as if they
+//    ended at cutTick
+//---------------------------------------------------------
+
+bool Xml::cutOff(const Spanner* s) const
+      {
+      return cutTick != -1 && s->tick() < cutTick && s->tick2() >= cutTick;
+      }
+
 }
 
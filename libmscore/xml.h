@@ -149,6 +149,7 @@ class Xml : public QTextStream {
       int curTrack  = -1;
       int tickDiff  =  0;
       int trackDiff =  0;           // saved track is curTrack-trackDiff
+      int cutTick   = -1;           // Score::write() stops at this tick
 
       bool clipboardmode = false;   // used to modify write() behaviour
       bool excerptmode   = false;   // true when writing a part
@@ -192,6 +193,7 @@ class Xml : public QTextStream {
       void setFilter(SelectionFilter f) { _filter = f; }
       bool canWrite(const Element*) const;
       bool canWriteVoice(int track) const;
+      bool cutOff(const Spanner*) const;
 
       static QString xmlString(const QString&);
       static QString xmlString(ushort c);
@@ -522,19 +522,24 @@ char* AlsaDriver::clear_32le(char* dst, int step, int nfrm)
 
 //---------------------------------------------------------
 //   write
+//    return the number of xruns recovered from while
+//    waiting for or writing to the device
 //---------------------------------------------------------
 
-void AlsaDriver::write(int n, float* l, float* r)
+int AlsaDriver::write(int n, float* l, float* r)
       {
+      int xruns = 0;
       for (;;) {
             int err = snd_pcm_wait(_play_handle, -1);
             if (err < 0) {
+                  ++xruns;
                   recover();
                   continue;
                   }
             int avail = snd_pcm_avail_update(_play_handle);
             if (avail < 0) {
                   qDebug("AlsaDriver::write: snd_pcm_avail_update() (%s)", snd_strerror(avail));
+                  ++xruns;
                   recover();
                   continue;
                   }
@@ -545,7 +550,11 @@ void AlsaDriver::write(int n, float* l, float* r)
             playInit(n);
             _play_ptr[0] = _play_func(l, _play_ptr[0], _play_step, n);
             _play_ptr[1] = _play_func(r, _play_ptr[1], _play_step, n);
-            snd_pcm_mmap_commit(_play_handle, _play_offs, n);
+            snd_pcm_sframes_t err = snd_pcm_mmap_commit(_play_handle, _play_offs, n);
+            if (err == -EPIPE) {
+                  ++xruns;
+                  recover();
+                  }
             }
       else {
             //
@@ -563,21 +572,26 @@ void AlsaDriver::write(int n, float* l, float* r)
                   void* bp[2];
                   bp[0] = lbuffer;
                   bp[1] = rbuffer;
-                  if ((err = snd_pcm_writen(_play_handle, bp, n)) < 0)
-                        qDebug("AlsaDriver::write(): failed (%s)", snd_strerror(err));
+                  err = snd_pcm_writen(_play_handle, bp, n);
                   }
             else if (_play_access == SND_PCM_ACCESS_RW_INTERLEAVED) {
                   short buffer[n * 2];
                   _play_func(l, (char*)buffer, 4, n);
                   _play_func(r, (char*)(buffer + 1), 4, n);
-                  if ((err = snd_pcm_writei(_play_handle, buffer, n)) < 0)
-                        qDebug("AlsaDriver::write(): failed (%s)", snd_strerror(err));
+                  err = snd_pcm_writei(_play_handle, buffer, n);
                   }
             else {
                   qDebug("AlsaDriver::write(): unsupported accesss type %d", _play_access);
-                  return;
+                  return xruns;
+                  }
+            if (err == -EPIPE) {          // underrun while writing
+                  ++xruns;
+                  recover();
                   }
+            else if (err < 0)
+                  qDebug("AlsaDriver::write(): failed (%s)", snd_strerror(err));
             }
+      return xruns;
       }
 
 //---------------------------------------------------------
@@ -688,7 +702,7 @@ void AlsaAudio::alsaLoop()
                   *lp++ = *sp++;
                   *rp++ = *sp++;
                   }
-            alsa->write(size, l, r);
+            _xruns += alsa->write(size, l, r);
             }
       alsa->pcmStop();
       runAlsa = 0;
@@ -101,7 +101,7 @@ class AlsaDriver {
       int pcmStop();
       snd_pcm_uframes_t fsize() const { return _frsize;      }
       unsigned int sampleRate() const { return _rate; }
-      void write(int n, float* l, float* r);
+      int write(int n, float* l, float* r);
       };
 
 //---------------------------------------------------------
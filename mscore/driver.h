@@ -21,6 +21,8 @@
 #ifndef __DRIVER_H__
 #define __DRIVER_H__
 
+#include <atomic>
+
 namespace Ms {
 
 class Seq;
@@ -36,6 +38,7 @@ class Driver {
 
    protected:
       Seq* seq;
+      std::atomic<unsigned> _xruns { 0 };    // buffers reported as skipped or late by the audio system
 
    public:
       Driver(Seq* s)    { seq = s; }
@@ -54,6 +57,8 @@ class Driver {
       virtual void checkTransportSeek(int, int, bool) {}
       virtual int bufferSize() {return 0;}
       virtual void updateOutPortCount(int) {}
+      unsigned xruns() const { return _xruns; }
+      void addXrun()         { ++_xruns; }
       };
 
 
@@ -79,131 +79,156 @@ bool MuseScore::saveAudio(Score* score, const QString& name)
             return false;
             }
 
-      QProgressDialog progress(this);
-      progress.setWindowFlags(Qt::WindowFlags(Qt::Dialog | Qt::FramelessWindowHint | Qt::WindowTitleHint));
-      progress.setWindowModality(Qt::ApplicationModal);
-      //progress.setCancelButton(0);
-      progress.setCancelButtonText(tr("Cancel"));
-      progress.setLabelText(tr("Exporting..."));
-      if (!MScore::noGui)
-            progress.show();
+      // the score is synthesized once into a temporary file of raw
+      // float samples while tracking the peak; the samples are then
+      // normalized while writing the sound file
+      QTemporaryFile tmp;
+      if (!tmp.open()) {
+            qDebug("open temporary file failed");
+            sf_close(sf);
+            QFile::remove(name);
+            delete synti;
+            MScore::sampleRate = oldSampleRate;
+            return false;
+            }
+
+      QProgressDialog* progress = 0;
+      if (!MScore::noGui) {
+            progress = new QProgressDialog(this);
+            progress->setWindowFlags(Qt::WindowFlags(Qt::Dialog | Qt::FramelessWindowHint | Qt::WindowTitleHint));
+            progress->setWindowModality(Qt::ApplicationModal);
+            progress->setCancelButtonText(tr("Cancel"));
+            progress->setLabelText(tr("Exporting..."));
+            progress->show();
+            }
 
       float peak  = 0.0;
-      double gain = 1.0;
       EventMap::const_iterator endPos = events.cend();
       --endPos;
       const int et = (score->utick2utime(endPos->first) + 1) * MScore::sampleRate;
-      progress.setRange(0, et);
-
-      for (int pass = 0; pass < 2; ++pass) {
-            EventMap::const_iterator playPos;
-            playPos = events.cbegin();
-            synti->allSoundsOff(-1);
-
-            //
-            // init instruments
-            //
-            foreach(Part* part, score->parts()) {
-                  const InstrumentList* il = part->instruments();
-                  for(auto i = il->begin(); i!= il->end(); i++) {
-                        foreach(const Channel* a, i->second->channel()) {
-                              a->updateInitList();
-                              foreach(MidiCoreEvent e, a->init) {
-                                    if (e.type() == ME_INVALID)
-                                          continue;
-                                    e.setChannel(a->channel);
-                                    int syntiIdx= synti->index(score->midiMapping(a->channel)->articulation->synti);
-                                    synti->play(e, syntiIdx);
-                                    }
+      if (progress)
+            progress->setRange(0, et);
+
+      EventMap::const_iterator playPos = events.cbegin();
+      synti->allSoundsOff(-1);
+
+      //
+      // init instruments
+      //
+      foreach(Part* part, score->parts()) {
+            const InstrumentList* il = part->instruments();
+            for(auto i = il->begin(); i!= il->end(); i++) {
+                  foreach(const Channel* a, i->second->channel()) {
+                        a->updateInitList();
+                        foreach(MidiCoreEvent e, a->init) {
+                              if (e.type() == ME_INVALID)
+                                    continue;
+                              e.setChannel(a->channel);
+                              int syntiIdx= synti->index(score->midiMapping(a->channel)->articulation->synti);
+                              synti->play(e, syntiIdx);
                               }
                         }
                   }
+            }
 
-            static const unsigned FRAMES = 512;
-            float buffer[FRAMES * 2];
-            int playTime = 0;
-
-            for (;;) {
-                  unsigned frames = FRAMES;
-                  //
-                  // collect events for one segment
-                  //
-                  float max = 0.0;
-                  memset(buffer, 0, sizeof(float) * FRAMES * 2);
-                  int endTime = playTime + frames;
-                  float* p = buffer;
-                  for (; playPos != events.cend(); ++playPos) {
-                        int f = score->utick2utime(playPos->first) * MScore::sampleRate;
-                        if (f >= endTime)
-                              break;
-                        int n = f - playTime;
-                        if (n) {
-                              synti->process(n, p);
-                              p += 2 * n;
-                              }
+      static const unsigned FRAMES = 512;
+      float buffer[FRAMES * 2];
+      int playTime = 0;
+      bool canceled = false;
+      bool ok       = true;
 
-                        playTime  += n;
-                        frames    -= n;
-                        const NPlayEvent& e = playPos->second;
-                        if (e.isChannelEvent()) {
-                              int channelIdx = e.channel();
-                              Channel* c = score->midiMapping(channelIdx)->articulation;
-                              if (!c->mute) {
-                                    synti->play(e, synti->index(c->synti));
-                                    }
-                              }
-                        }
-                  if (frames) {
-                        synti->process(frames, p);
-                        playTime += frames;
-                        }
-                  if (pass == 1) {
-                        for (unsigned i = 0; i < FRAMES * 2; ++i) {
-                              max = qMax(max, qAbs(buffer[i]));
-                              buffer[i] *= gain;
-                              }
-                        sf_writef_float(sf, buffer, FRAMES);
+      for (;;) {
+            unsigned frames = FRAMES;
+            //
+            // collect events for one segment
+            //
+            float max = 0.0;
+            memset(buffer, 0, sizeof(float) * FRAMES * 2);
+            int endTime = playTime + frames;
+            float* p = buffer;
+            for (; playPos != events.cend(); ++playPos) {
+                  int f = score->utick2utime(playPos->first) * MScore::sampleRate;
+                  if (f >= endTime)
+                        break;
+                  int n = f - playTime;
+                  if (n) {
+                        synti->process(n, p);
+                        p += 2 * n;
                         }
-                  else {
-                        for (unsigned i = 0; i < FRAMES * 2; ++i) {
-                              max = qMax(max, qAbs(buffer[i]));
-                              peak = qMax(peak, qAbs(buffer[i]));
+
+                  playTime  += n;
+                  frames    -= n;
+                  const NPlayEvent& e = playPos->second;
+                  if (e.isChannelEvent()) {
+                        int channelIdx = e.channel();
+                        Channel* c = score->midiMapping(channelIdx)->articulation;
+                        if (!c->mute) {
+                              synti->play(e, synti->index(c->synti));
                               }
                         }
-                  playTime = endTime;
-                  if (!MScore::noGui) {
-                        if (progress.wasCanceled())
-                              break;
-                        progress.setValue((pass * et + playTime) / 2);
-                        qApp->processEvents();
-                        }
-                  if (playTime >= et)
-                        synti->allNotesOff(-1);
-                  // create sound until the sound decays
-                  if (playTime >= et && max*peak < 0.000001)
+                  }
+            if (frames) {
+                  synti->process(frames, p);
+                  playTime += frames;
+                  }
+            for (unsigned i = 0; i < FRAMES * 2; ++i)
+                  max = qMax(max, qAbs(buffer[i]));
+            peak = qMax(peak, max);
+            if (tmp.write(reinterpret_cast<const char*>(buffer), sizeof(buffer)) != sizeof(buffer)) {
+                  qDebug("write temporary file failed");
+                  ok = false;
+                  break;
+                  }
+            playTime = endTime;
+            if (progress) {
+                  if (progress->wasCanceled()) {
+                        canceled = true;
                         break;
+                        }
+                  progress->setValue(playTime);
+                  qApp->processEvents();
                   }
-            if (progress.wasCanceled())
+            if (playTime >= et)
+                  synti->allNotesOff(-1);
+            // create sound until the sound decays
+            if (playTime >= et && max*peak < 0.000001)
                   break;
-            if (pass == 0 && peak == 0.0) {
+            }
+
+      MScore::sampleRate = oldSampleRate;
+      delete synti;
+
+      if (ok && !canceled) {
+            if (peak == 0.0)
                   qDebug("song is empty");
-                  break;
+            else {
+                  double gain = 0.99 / peak;
+                  tmp.seek(0);
+                  for (;;) {
+                        qint64 n = tmp.read(reinterpret_cast<char*>(buffer), sizeof(buffer));
+                        if (n <= 0)
+                              break;
+                        unsigned frames = n / (sizeof(float) * 2);
+                        for (unsigned i = 0; i < frames * 2; ++i)
+                              buffer[i] *= gain;
+                        sf_writef_float(sf, buffer, frames);
+                        }
                   }
-            gain = 0.99 / peak;
             }
 
-      progress.close();
+      if (progress) {
+            progress->close();
+            delete progress;
+            }
 
-      MScore::sampleRate = oldSampleRate;
-      delete synti;
       if (sf_close(sf)) {
             qDebug("close soundfile failed");
             return false;
             }
-      if (progress.wasCanceled())
+      if (canceled || !ok)
             QFile::remove(name);
 
-      return true;
+      return ok;
       }
 
 #endif // HAS_AUDIOFILE
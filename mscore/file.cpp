@@ -123,6 +123,60 @@ static void paintElements(QPainter& p, const QList<const Element*>& el)
             }
       }
 
+//---------------------------------------------------------
+//   paintPage
+//---------------------------------------------------------
+
+static void paintPage(QPainter& p, Page* page)
+      {
+      QList<const Element*> pel = page->elements();
+      qStableSort(pel.begin(), pel.end(), elementLessThan);
+      paintElements(p, pel);
+      }
+
+//---------------------------------------------------------
+//   recordPage
+//---------------------------------------------------------
+
+static QPicture recordPage(Page* page)
+      {
+      QPicture picture;
+      QPainter p(&picture);
+      paintPage(p, page);
+      p.end();
+      return picture;
+      }
+
+//---------------------------------------------------------
+//   parallelPainting
+//    Pages of a laid out score are painted concurrently
+//    if the platform can render fonts outside of the gui
+//    thread. Painting does not change the score.
+//---------------------------------------------------------
+
+static bool parallelPainting()
+      {
+      return QFontDatabase::supportsThreadedFontRendering() && QThreadPool::globalInstance()->maxThreadCount() > 1;
+      }
+
+//---------------------------------------------------------
+//   recordPages
+//    record the pages of score as pictures, to be played
+//    back in page order
+//---------------------------------------------------------
+
+static QList<QPicture> recordPages(Score* score)
+      {
+      QList<Page*> pl = score->pages();
+      ScoreFont::fallbackFont();          // load it here instead of on the first page with symbol text
+      if (parallelPainting())
+            return QtConcurrent::blockingMapped(pl, recordPage);
+      QList<QPicture> pictures;
+      for (Page* page : pl)
+            pictures.append(recordPage(page));
+      return pictures;
+      }
+
 //---------------------------------------------------------
 //   createDefaultFileName
 //---------------------------------------------------------
@@ -231,6 +285,8 @@ static bool readScoreError(const QString& name, Score::FileError error, bool ask
 
 bool MuseScore::checkDirty(Score* s)
       {
+      if (converterMode)      // nobody to ask
+            return false;
       if (s->dirty() || s->created()) {
             QMessageBox::StandardButton n = QMessageBox::warning(this, tr("MuseScore"),
                tr("Save changes to the score \"%1\"\n"
@@ -424,6 +480,7 @@ bool MuseScore::saveFile(Score* score)
             tab2->setTabText(idx, score->name());
       QString tmp = score->tmpName();
       if (!tmp.isEmpty()) {
+            waitForAutoSave();
             QFile f(tmp);
             if (!f.remove())
                   qDebug("cannot remove temporary file <%s>", qPrintable(f.fileName()));
@@ -1912,14 +1969,13 @@ bool MuseScore::savePdf(Score* cs, const QString& saveName)
       double mag = printerDev.logicalDpiX() / MScore::DPI;
       p.scale(mag, mag);
 
-      const QList<Page*> pl = cs->pages();
-      int pages    = pl.size();
+      const QList<QPicture> pictures = recordPages(cs);
       bool firstPage = true;
-      for (int n = 0; n < pages; ++n) {
+      for (const QPicture& picture : pictures) {
             if (!firstPage)
                   printerDev.newPage();
             firstPage = false;
-            cs->print(&p, n);
+            p.drawPicture(0, 0, picture);
             }
       p.end();
       cs->setPrinting(false);
@@ -1970,13 +2026,12 @@ bool MuseScore::savePdf(QList<Score*> cs, const QString& saveName)
             const PageFormat* pf = s->pageFormat();
             printerDev.setPaperSize(pf->size(), QPrinter::Inch);
 
-            const QList<Page*> pl = s->pages();
-            int pages    = pl.size();
-            for (int n = 0; n < pages; ++n) {
+            const QList<QPicture> pictures = recordPages(s);
+            for (const QPicture& picture : pictures) {
                   if (!firstPage)
                         printerDev.newPage();
                   firstPage = false;
-                  s->print(&p, n);
+                  p.drawPicture(0, 0, picture);
                   }
             //reset score
             s->setPrinting(false);
@@ -2322,73 +2377,95 @@ bool MuseScore::savePng(Score* score, const QString& name)
       }
 
 //---------------------------------------------------------
-//   savePng with options
+//   PngPage
+//    one page of a png export
+//---------------------------------------------------------
+
+struct PngPage {
+      Page* page;
+      QString fileName;
+      bool transparent;
+      double dpi;
+      int trimMargin;
+      QImage::Format format;
+      };
+
+//---------------------------------------------------------
+//   savePngPage
+//    paint, convert and write one page
 //    return true on success
 //---------------------------------------------------------
 
-bool MuseScore::savePng(Score* score, const QString& name, bool screenshot, bool transparent, double convDpi, int trimMargin, QImage::Format format)
+static bool savePngPage(const PngPage& pp)
       {
-      bool rv = true;
-      score->setPrinting(!screenshot);    // dont print page break symbols etc.
-
       QImage::Format f;
-      if (format != QImage::Format_Indexed8)
-          f = format;
+      if (pp.format != QImage::Format_Indexed8)
+          f = pp.format;
       else
           f = QImage::Format_ARGB32_Premultiplied;
 
+      QRectF r;
+      if (pp.trimMargin >= 0) {
+            QMarginsF margins(pp.trimMargin, pp.trimMargin, pp.trimMargin, pp.trimMargin);
+            r = pp.page->tbbox() + margins;
+            }
+      else
+            r = pp.page->abbox();
+      int w = lrint(r.width()  * pp.dpi / MScore::DPI);
+      int h = lrint(r.height() * pp.dpi / MScore::DPI);
+
+      QImage printer(w, h, f);
+      printer.setDotsPerMeterX(lrint((pp.dpi * 1000) / INCH));
+      printer.setDotsPerMeterY(lrint((pp.dpi * 1000) / INCH));
+
+      printer.fill(pp.transparent ? 0 : 0xffffffff);
+
+      double mag = pp.dpi / MScore::DPI;
+      QPainter p(&printer);
+      p.setRenderHint(QPainter::Antialiasing, true);
+      p.setRenderHint(QPainter::TextAntialiasing, true);
+      p.scale(mag, mag);
+      if (pp.trimMargin >= 0)
+            p.translate(-r.topLeft());
+      paintPage(p, pp.page);
+      p.end();
+
+      if (pp.format == QImage::Format_Indexed8) {
+            //convert to grayscale & respect alpha
+            QVector<QRgb> colorTable;
+            colorTable.push_back(QColor(0, 0, 0, 0).rgba());
+            if (!pp.transparent) {
+                  for (int i = 1; i < 256; i++)
+                        colorTable.push_back(QColor(i, i, i).rgb());
+                  }
+            else {
+                  for (int i = 1; i < 256; i++)
+                        colorTable.push_back(QColor(0, 0, 0, i).rgba());
+                  }
+            printer = printer.convertToFormat(QImage::Format_Indexed8, colorTable);
+            }
+      return printer.save(pp.fileName, "png");
+      }
+
+//---------------------------------------------------------
+//   savePng with options
+//    Pages are painted, converted and written
+//    concurrently.
+//    return true on success
+//---------------------------------------------------------
+
+bool MuseScore::savePng(Score* score, const QString& name, bool screenshot, bool transparent, double convDpi, int trimMargin, QImage::Format format)
+      {
+      score->setPrinting(!screenshot);    // dont print page break symbols etc.
+
       const QList<Page*>& pl = score->pages();
       int pages = pl.size();
 
       int padding = QString("%1").arg(pages).size();
       bool overwrite = false;
       bool noToAll = false;
+      QList<PngPage> pngPages;
       for (int pageNumber = 0; pageNumber < pages; ++pageNumber) {
-            Page* page = pl.at(pageNumber);
-
-            QRectF r;
-            if (trimMargin >= 0) {
-                  QMarginsF margins(trimMargin, trimMargin, trimMargin, trimMargin);
-                  r = page->tbbox() + margins;
-                  }
-            else
-                  r = page->abbox();
-            int w = lrint(r.width()  * convDpi / MScore::DPI);
-            int h = lrint(r.height() * convDpi / MScore::DPI);
-
-            QImage printer(w, h, f);
-            printer.setDotsPerMeterX(lrint((convDpi * 1000) / INCH));
-            printer.setDotsPerMeterY(lrint((convDpi * 1000) / INCH));
-
-            printer.fill(transparent ? 0 : 0xffffffff);
-
-            double mag = convDpi / MScore::DPI;
-            QPainter p(&printer);
-            p.setRenderHint(QPainter::Antialiasing, true);
-            p.setRenderHint(QPainter::TextAntialiasing, true);
-            p.scale(mag, mag);
-            if (trimMargin >= 0)
-                  p.translate(-r.topLeft());
-
-            QList<const Element*> pel = page->elements();
-            qStableSort(pel.begin(), pel.end(), elementLessThan);
-            paintElements(p, pel);
-
-            if (format == QImage::Format_Indexed8) {
-                  //convert to grayscale & respect alpha
-                  QVector<QRgb> colorTable;
-                  colorTable.push_back(QColor(0, 0, 0, 0).rgba());
-                  if (!transparent) {
-                        for (int i = 1; i < 256; i++)
-                              colorTable.push_back(QColor(i, i, i).rgb());
-                        }
-                  else {
-                        for (int i = 1; i < 256; i++)
-                              colorTable.push_back(QColor(0, 0, 0, i).rgba());
-                        }
-                  printer = printer.convertToFormat(QImage::Format_Indexed8, colorTable);
-                  }
-
             QString fileName(name);
             if (fileName.endsWith(".png"))
                   fileName = fileName.left(fileName.size() - 4);
@@ -2417,12 +2494,19 @@ bool MuseScore::savePng(Score* score, const QString& name, bool screenshot, bool
                               continue;
                         }
                   }
-            rv = printer.save(fileName, "png");
-            if (!rv)
-                  break;
+            pngPages.append(PngPage { pl.at(pageNumber), fileName, transparent, convDpi, trimMargin, format });
+            }
+
+      // screenshots of images use pixmap buffers of the gui thread
+      QList<bool> results;
+      if (!screenshot && parallelPainting())
+            results = QtConcurrent::blockingMapped(pngPages, savePngPage);
+      else {
+            for (const PngPage& pp : pngPages)
+                  results.append(savePngPage(pp));
             }
       cs->setPrinting(false);
-      return rv;
+      return !results.contains(false);
       }
 
 //---------------------------------------------------------
@@ -2556,10 +2640,8 @@ bool MuseScore::saveSvg(Score* score, const QString& saveName)
       if (trimMargin >= 0 && score->npages() == 1)
             p.translate(-r.topLeft());
 
-      foreach (Page* page, score->pages()) {
-            QList<const Element*> pel = page->elements();
-            qStableSort(pel.begin(), pel.end(), elementLessThan);
-            paintElements(p, pel);
+      for (const QPicture& picture : recordPages(score)) {
+            p.drawPicture(0, 0, picture);
             p.translate(QPointF(pf->width() * MScore::DPI, 0.0));
             }
 
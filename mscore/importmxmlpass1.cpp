@@ -543,7 +543,8 @@ void MusicXMLParserPass1::logError(const QString& error)
 
 void MusicXMLParserPass1::skipLogCurrElem()
       {
-      logDebugInfo(QString("skipping '%1'").arg(_e.name().toString()));
+      if (MScore::debugMode)
+            logDebugInfo(QString("skipping '%1'").arg(_e.name().toString()));
       _e.skipCurrentElement();
       }
 
@@ -2659,8 +2660,10 @@ void MusicXMLParserPass1::note(const QString& partId,
       // convert staff to zero-based
       staff--;
 
+      MusicXmlPart& mxmlPart = _parts[partId];
+
       // multi-instrument handling
-      QString prevInstrId = _parts[partId]._instrList.instrument(sTime);
+      QString prevInstrId = mxmlPart._instrList.instrument(sTime);
       bool mustInsert = instrId != prevInstrId;
       /*
       qDebug("tick %s (%d) staff %d voice '%s' previnst='%s' instrument '%s' insert %d",
@@ -2674,7 +2677,7 @@ void MusicXMLParserPass1::note(const QString& partId,
              );
       */
       if (mustInsert)
-            _parts[partId]._instrList.setInstrument(instrId, sTime);
+            mxmlPart._instrList.setInstrument(instrId, sTime);
 
       // normalize duration
       if (dura.isValid())
@@ -2725,11 +2728,11 @@ void MusicXMLParserPass1::note(const QString& partId,
       // store result
       if (dura.isValid() && dura > Fraction(0, 1)) {
             // count the chords
-            if (!_parts.value(partId).voicelist.contains(voice)) {
+            if (!mxmlPart.voicelist.contains(voice)) {
                   VoiceDesc vs;
-                  _parts[partId].voicelist.insert(voice, vs);
+                  mxmlPart.voicelist.insert(voice, vs);
                   }
-            _parts[partId].voicelist[voice].incrChordRests(staff);
+            mxmlPart.voicelist[voice].incrChordRests(staff);
             // determine note length for voice overlap detection
             // TODO
             vod.addNote(sTime.ticks(), (sTime + dura).ticks(), voice, staff);
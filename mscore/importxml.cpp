@@ -569,6 +569,7 @@ static bool extractRootfile(QFile* qf, QByteArray& data)
 
 /**
  Validate MusicXML data from file \a name contained in QIODevice \a dev.
+ The schema is loaded once and kept for all further imports.
  */
 
 static Score::FileError doValidate(const QString& name, QIODevice* dev)
@@ -577,14 +578,18 @@ static Score::FileError doValidate(const QString& name, QIODevice* dev)
       t.start();
 
       // initialize the schema
-      ValidatorMessageHandler messageHandler;
-      QXmlSchema schema;
-      schema.setMessageHandler(&messageHandler);
-      if (!initMusicXmlSchema(schema))
-            return Score::FileError::FILE_BAD_FORMAT;  // appropriate error message has been printed by initMusicXmlSchema
+      static QXmlSchema schema;
+      static bool schemaLoaded = false;
+      if (!schemaLoaded) {
+            if (!initMusicXmlSchema(schema))
+                  return Score::FileError::FILE_BAD_FORMAT;  // appropriate error message has been printed by initMusicXmlSchema
+            schemaLoaded = true;
+            }
 
       // validate the data
+      ValidatorMessageHandler messageHandler;
       QXmlSchemaValidator validator(schema);
+      validator.setMessageHandler(&messageHandler);
       bool valid = validator.validate(dev, QUrl::fromLocalFile(name));
       qDebug("Validation time elapsed: %d ms", t.elapsed());
 
@@ -645,13 +650,14 @@ static Score::FileError doImport(Score* score, const QString& name, QIODevice* d
 static Score::FileError doValidateAndImport(Score* score, const QString& name, QIODevice* dev)
       {
       // validate the file
-      Score::FileError res;
-      res = doValidate(name, dev);
+      Score::FileError res = Score::FileError::FILE_NO_ERROR;
+      if (preferences.musicxmlImportValidate)
+            res = doValidate(name, dev);
       if (res != Score::FileError::FILE_NO_ERROR)
             return res;
 
 #ifdef PULL_PARSER
-      importMusicXMLfromBuffer(score, name, dev);
+      res = importMusicXMLfromBuffer(score, name, dev);
 #else
       // pass 1
       dev->seek(0);
@@ -301,6 +301,16 @@ static int graph_callback(void*)
       return 0;
       }
 
+//---------------------------------------------------------
+//   xrunCallback
+//---------------------------------------------------------
+
+static int xrunCallback(void* arg)
+      {
+      static_cast<JackAudio*>(arg)->addXrun();
+      return 0;
+      }
+
 //---------------------------------------------------------
 //   timebase
 //---------------------------------------------------------
@@ -464,6 +474,7 @@ bool JackAudio::init(bool hot)
       jack_set_port_registration_callback(client, registration_callback, this);
       jack_set_graph_order_callback(client, graph_callback, this);
       jack_set_freewheel_callback (client, freewheel_callback, this);
+      jack_set_xrun_callback(client, xrunCallback, this);
       if (preferences.jackTimebaseMaster)
             setTimebaseCallback();
       if (jack_set_buffer_size_callback (client, bufferSizeCallback, this) != 0)
@@ -11,6 +11,9 @@
 //=============================================================================
 
 #include <fenv.h>
+#ifdef Q_OS_UNIX
+#include <unistd.h>
+#endif
 
 #include "palettebox.h"
 #include "config.h"
@@ -46,6 +49,7 @@
 #include "magbox.h"
 #include "libmscore/sig.h"
 #include "libmscore/undo.h"
+#include "libmscore/trace.h"
 #include "synthcontrol.h"
 #include "pianoroll.h"
 #include "drumroll.h"
@@ -90,6 +94,7 @@
 #include "libmscore/volta.h"
 #include "libmscore/lasso.h"
 #include "libmscore/excerpt.h"
+#include "libmscore/memoryreport.h"
 
 #include "driver.h"
 
@@ -98,6 +103,7 @@
 #include "synthesizer/synthesizer.h"
 #include "synthesizer/synthesizergui.h"
 #include "synthesizer/msynthesizer.h"
+#include "synthesizer/samplememory.h"
 #include "fluid/fluid.h"
 #include "qmlplugin.h"
 #include "accessibletoolbutton.h"
@@ -140,6 +146,13 @@ static QString outFileName;
 static QString audioDriver;
 static QString pluginName;
 static QString styleFile;
+static QString jobFile;
+static QString jobReportFile;
+static int jobWorkers = 1;
+static QString traceFile;
+static bool audioLoadReport = false;
+static bool memoryReport = false;
+static bool noMusicXmlValidation = false;
 static bool scoresOnCommandline { false };
 
 QString localeName;
@@ -259,6 +272,7 @@ void MuseScore::closeEvent(QCloseEvent* ev)
       foreach(Score* score, removeList)
             scoreList.removeAll(score);
 
+      waitForAutoSave();
       writeSessionFile(true);
       foreach(Score* score, scoreList) {
             if (!score->tmpName().isEmpty()) {
@@ -325,6 +339,9 @@ void MuseScore::preferencesChanged()
                   }
             }
 
+      if (navigator())
+            navigator()->updateAll();       // selection and voice colours
+
       transportTools->setEnabled(!noSeq && seq && seq->isRunning());
       playId->setEnabled(!noSeq && seq && seq->isRunning());
 
@@ -358,7 +375,7 @@ MuseScore::MuseScore()
                   }
             }
 
-      if (!converterMode && !pluginMode) {
+      if (!converterMode && !pluginMode && !memoryReport) {
             _loginManager = new LoginManager(this);
 
             // initialize help engine
@@ -1850,6 +1867,7 @@ void MuseScore::removeTab(int i)
             setCurrentScoreView((firstTab ? tab1 : tab2)->view());
       writeSessionFile(false);
       if (!tmpName.isEmpty()) {
+            waitForAutoSave();
             QFile f(tmpName);
             f.remove();
             }
@@ -2035,12 +2053,366 @@ static void loadScores(const QStringList& argv)
       mscore->setCurrentView(1, currentScoreView);
       }
 
+//---------------------------------------------------------
+//   convert
+//    export score cs to file fn, the format depends on
+//    the file extension
+//---------------------------------------------------------
+
+static bool convert(Score* cs, const QString& fn)
+      {
+      bool rv = true;
+      LayoutMode layoutMode = cs->layoutMode();
+      if (!styleFile.isEmpty()) {
+            QFile f(styleFile);
+            if (f.open(QIODevice::ReadOnly)) {
+                  cs->style()->load(&f);
+                  }
+            }
+      if (fn.endsWith(".mscx")) {
+            QFileInfo fi(fn);
+            try {
+                  cs->saveFile(fi);
+                  }
+            catch(QString) {
+                  return false;
+                  }
+            return true;
+            }
+      else if (fn.endsWith(".mscz")) {
+            QFileInfo fi(fn);
+            try {
+                  cs->saveCompressedFile(fi, false);
+                  }
+            catch(QString) {
+                  return false;
+                  }
+            return true;
+            }
+      else if (fn.endsWith(".xml")) {
+            if (layoutMode != LayoutMode::PAGE) {
+                  cs->startCmd();
+                  cs->undo(new ChangeLayoutMode(cs, LayoutMode::PAGE));
+                  cs->doLayout();
+                  }
+            rv = saveXml(cs, fn);
+            }
+      else if (fn.endsWith(".mxl")) {
+            if (layoutMode != LayoutMode::PAGE) {
+                  cs->startCmd();
+                  cs->undo(new ChangeLayoutMode(cs, LayoutMode::PAGE));
+                  cs->doLayout();
+                  }
+            rv = saveMxl(cs, fn);
+            }
+      else if (fn.endsWith(".mid"))
+            return mscore->saveMidi(cs, fn);
+      else if (fn.endsWith(".pdf")) {
+            if (!exportScoreParts) {
+                  if (layoutMode != LayoutMode::PAGE) {
+                        cs->startCmd();
+                        cs->undo(new ChangeLayoutMode(cs, LayoutMode::PAGE));
+                        cs->doLayout();
+                  }
+                  rv = mscore->savePdf(cs, fn);
+                  }
+            else {
+                  if (cs->excerpts().size() == 0) {
+                        QList<Excerpt*> exceprts = Excerpt::createAllExcerpt(cs);
+
+                        foreach(Excerpt* e, exceprts) {
+                              Score* nscore = new Score(e->oscore());
+                              e->setPartScore(nscore);
+                              nscore->setName(e->title()); // needed before AddExcerpt
+                              nscore->style()->set(StyleIdx::createMultiMeasureRests, true);
+                              cs->startCmd();
+                              cs->undo(new AddExcerpt(nscore));
+                              createExcerpt(e);
+                              cs->endCmd();
+                              }
+                        }
+                  QList<Score*> scores;
+                  scores.append(cs);
+                  foreach(Excerpt* e, cs->excerpts())
+                        scores.append(e->partScore());
+                  return mscore->savePdf(scores, fn);
+                  }
+            }
+      else if (fn.endsWith(".png")) {
+            if (layoutMode != LayoutMode::PAGE) {
+                  cs->startCmd();
+                  cs->undo(new ChangeLayoutMode(cs, LayoutMode::PAGE));
+                  cs->doLayout();
+                  }
+            rv = mscore->savePng(cs, fn);
+            }
+      else if (fn.endsWith(".svg")) {
+            if (layoutMode != LayoutMode::PAGE) {
+                  cs->startCmd();
+                  cs->undo(new ChangeLayoutMode(cs, LayoutMode::PAGE));
+                  cs->doLayout();
+                  }
+            rv = mscore->saveSvg(cs, fn);
+            }
+#ifdef HAS_AUDIOFILE
+      else if (fn.endsWith(".wav") || fn.endsWith(".ogg") || fn.endsWith(".flac"))
+            return mscore->saveAudio(cs, fn);
+#endif
+#ifdef USE_LAME
+      else if (fn.endsWith(".mp3"))
+            return mscore->saveMp3(cs, fn);
+#endif
+      else if (fn.endsWith(".spos")) {
+            if (layoutMode != LayoutMode::PAGE) {
+                  cs->startCmd();
+                  cs->undo(new ChangeLayoutMode(cs, LayoutMode::PAGE));
+                  cs->doLayout();
+                  }
+            rv = savePositions(cs, fn, true);
+            }
+      else if (fn.endsWith(".mpos")) {
+            if (layoutMode != LayoutMode::PAGE) {
+                  cs->startCmd();
+                  cs->undo(new ChangeLayoutMode(cs, LayoutMode::PAGE));
+                  cs->doLayout();
+                  }
+            rv = savePositions(cs, fn, false);
+            }
+      else if (fn.endsWith(".mlog"))
+            return cs->sanityCheck(fn);
+      else {
+            qDebug("dont know how to convert to %s", qPrintable(fn));
+            return false;
+            }
+      if (layoutMode != cs->layoutMode())
+            cs->endCmd(true);       // rollback
+      return rv;
+      }
+
+//---------------------------------------------------------
+//   convertJob
+//    convert one score of a job file into all its output
+//    files, append the results to the report
+//---------------------------------------------------------
+
+static bool convertJob(const QString& in, const QStringList& out, QJsonArray* report)
+      {
+      QElapsedTimer timer;
+      timer.start();
+      Score* score = mscore->readScore(in);
+      qint64 loadTime = timer.elapsed();
+      bool rv = score != 0;
+      if (score) {
+            int idx = mscore->appendScore(score);
+            mscore->setCurrentScoreView(idx);
+            }
+      for (const QString& fn : out) {
+            QJsonObject o;
+            o["in"]  = in;
+            o["out"] = fn;
+            if (score) {
+                  timer.restart();
+                  bool ok = convert(score, fn);
+                  o["ok"]   = ok;
+                  o["load"] = loadTime;
+                  o["time"] = timer.elapsed();
+                  rv = rv && ok;
+                  }
+            else {
+                  o["ok"]    = false;
+                  o["error"] = QString("cannot read score");
+                  }
+            report->append(o);
+            }
+      if (score)
+            mscore->removeTab(mscore->scores().indexOf(score));
+      return rv;
+      }
+
+//---------------------------------------------------------
+//   readJobs
+//    a job file is a json array of objects with an input
+//    score and one or more output files:
+//      [ { "in": "a.mscz", "out": "a.pdf" },
+//        { "in": "b.mscz", "out": [ "b.pdf", "b.mid" ] } ]
+//    "-" reads the job list from stdin
+//---------------------------------------------------------
+
+static bool readJobs(const QString& path, QJsonArray* jobs)
+      {
+      QFile f(path);
+      bool ok;
+      if (path == "-")
+            ok = f.open(stdin, QIODevice::ReadOnly);
+      else
+            ok = f.open(QIODevice::ReadOnly);
+      if (!ok) {
+            qDebug("cannot open job file <%s>", qPrintable(path));
+            return false;
+            }
+      QJsonParseError error;
+      QJsonDocument doc = QJsonDocument::fromJson(f.readAll(), &error);
+      if (!doc.isArray()) {
+            qDebug("bad job file <%s>: %s", qPrintable(path), qPrintable(error.errorString()));
+            return false;
+            }
+      *jobs = doc.array();
+      return true;
+      }
+
+//---------------------------------------------------------
+//   readJobReport
+//---------------------------------------------------------
+
+static bool readJobReport(const QString& path, QJsonArray* report)
+      {
+      QFile f(path);
+      if (!f.open(QIODevice::ReadOnly)) {
+            qDebug("cannot open job report <%s>", qPrintable(path));
+            return false;
+            }
+      QJsonParseError error;
+      QJsonDocument doc = QJsonDocument::fromJson(f.readAll(), &error);
+      if (!doc.isArray()) {
+            qDebug("bad job report <%s>: %s", qPrintable(path), qPrintable(error.errorString()));
+            return false;
+            }
+      for (const QJsonValue& v : doc.array())
+            report->append(v);
+      return true;
+      }
+
+//---------------------------------------------------------
+//   writeJobReport
+//---------------------------------------------------------
+
+static bool writeJobReport(const QString& path, const QJsonArray& report)
+      {
+      QFile f(path);
+      if (!f.open(QIODevice::WriteOnly)) {
+            qDebug("cannot write job report <%s>", qPrintable(path));
+            return false;
+            }
+      return f.write(QJsonDocument(report).toJson()) != -1;
+      }
+
+//---------------------------------------------------------
+//   workerArguments
+//    command line for a worker process: all options except
+//    the job, report and trace options
+//---------------------------------------------------------
+
+static QStringList workerArguments(const QString& jobFile, const QString& reportFile)
+      {
+      QStringList args = QCoreApplication::arguments();
+      args.removeFirst();
+      static const QStringList jobOptions { "-j", "--job", "--job-report", "--job-workers", "--trace" };
+      for (int i = 0; i < args.size();) {
+            const QString& a = args[i];
+            if (jobOptions.contains(a))
+                  args.erase(args.begin() + i, args.begin() + qMin(i + 2, args.size()));
+            else if (a.startsWith("--job=") || a.startsWith("--job-report=")
+               || a.startsWith("--job-workers=") || a.startsWith("--trace="))
+                  args.removeAt(i);
+            else
+                  ++i;
+            }
+      args << "--job" << jobFile << "--job-report" << reportFile;
+      // every worker writes its own trace
+      if (!traceFile.isEmpty())
+            args << "--trace" << traceFile + "." + QFileInfo(jobFile).fileName() + ".json";
+      return args;
+      }
+
+//---------------------------------------------------------
+//   processJobs
+//    convert all jobs of the job file and write a json
+//    report to the job report file, if one is given. With
+//    more than one worker, the jobs are distributed to
+//    worker processes which pay the startup cost only
+//    once each; every worker writes its report to
+//    <job file>.report.json, which is merged here.
+//---------------------------------------------------------
+
+static bool processJobs()
+      {
+      QJsonArray jobs;
+      if (!readJobs(jobFile, &jobs))
+            return false;
+
+      bool rv = true;
+      QJsonArray report;
+      int workers = qMin(jobWorkers, jobs.size());
+      if (workers > 1) {
+            QList<QTemporaryFile*> files;
+            QList<QProcess*> processes;
+            for (int i = 0; i < workers; ++i) {
+                  QJsonArray wjobs;
+                  for (int k = i; k < jobs.size(); k += workers)
+                        wjobs.append(jobs[k]);
+                  QTemporaryFile* tf = new QTemporaryFile;
+                  if (!tf->open()) {
+                        qDebug("cannot create job file for worker %d", i);
+                        delete tf;
+                        rv = false;
+                        continue;
+                        }
+                  tf->write(QJsonDocument(wjobs).toJson());
+                  tf->close();
+                  files.append(tf);
+                  QProcess* p = new QProcess;
+                  p->setProcessChannelMode(QProcess::ForwardedChannels);
+                  p->start(QCoreApplication::applicationFilePath(),
+                     workerArguments(tf->fileName(), tf->fileName() + ".report.json"));
+                  processes.append(p);
+                  }
+            for (int i = 0; i < processes.size(); ++i) {
+                  QProcess* p = processes[i];
+                  p->waitForFinished(-1);
+                  if (p->exitStatus() != QProcess::NormalExit || p->exitCode() != 0)
+                        rv = false;
+                  QString reportFile = files[i]->fileName() + ".report.json";
+                  if (!readJobReport(reportFile, &report))
+                        rv = false;
+                  QFile::remove(reportFile);
+                  }
+            qDeleteAll(processes);
+            qDeleteAll(files);
+            }
+      else {
+            for (const QJsonValue& v : jobs) {
+                  QJsonObject job = v.toObject();
+                  QStringList out;
+                  if (job["out"].isArray()) {
+                        for (const QJsonValue& o : job["out"].toArray())
+                              out.append(o.toString());
+                        }
+                  else
+                        out.append(job["out"].toString());
+                  if (!convertJob(job["in"].toString(), out, &report))
+                        rv = false;
+                  }
+            }
+      if (!jobReportFile.isEmpty() && !writeJobReport(jobReportFile, report))
+            rv = false;
+      return rv;
+      }
+
 //---------------------------------------------------------
 //   processNonGui
 //---------------------------------------------------------
 
 static bool processNonGui()
       {
+      if (memoryReport) {
+            for (Score* score : mscore->scores()) {
+                  MemoryReport report;
+                  report.add(score);
+                  QTextStream(stdout) << score->name() << ":\n" << report.toString() << "\n";
+                  }
+            if (!converterMode && !pluginMode)
+                  return true;
+            }
       if (pluginMode) {
             QString pn(pluginName);
             bool res = false;
@@ -2068,138 +2440,15 @@ static bool processNonGui()
             if (!converterMode)
                   return res;
             }
-      bool rv = true;
       if (converterMode) {
-            QString fn(outFileName);
+            if (!jobFile.isEmpty())
+                  return processJobs();
             Score* cs = mscore->currentScore();
             if (!cs)
                   return false;
-            LayoutMode layoutMode = cs->layoutMode();
-            if (!styleFile.isEmpty()) {
-                  QFile f(styleFile);
-                  if (f.open(QIODevice::ReadOnly)) {
-                        cs->style()->load(&f);
-                        }
-                  }
-            if (fn.endsWith(".mscx")) {
-                  QFileInfo fi(fn);
-                  try {
-                        cs->saveFile(fi);
-                        }
-                  catch(QString) {
-                        return false;
-                        }
-                  return true;
-                  }
-            else if (fn.endsWith(".mscz")) {
-                  QFileInfo fi(fn);
-                  try {
-                        cs->saveCompressedFile(fi, false);
-                        }
-                  catch(QString) {
-                        return false;
-                        }
-                  return true;
-                  }
-            else if (fn.endsWith(".xml")) {
-                  if (layoutMode != LayoutMode::PAGE) {
-                        cs->startCmd();
-                        cs->undo(new ChangeLayoutMode(cs, LayoutMode::PAGE));
-                        cs->doLayout();
-                        }
-                  rv = saveXml(cs, fn);
-                  }
-            else if (fn.endsWith(".mxl")) {
-                  if (layoutMode != LayoutMode::PAGE) {
-                        cs->startCmd();
-                        cs->undo(new ChangeLayoutMode(cs, LayoutMode::PAGE));
-                        cs->doLayout();
-                        }
-                  rv = saveMxl(cs, fn);
-                  }
-            else if (fn.endsWith(".mid"))
-                  return mscore->saveMidi(cs, fn);
-            else if (fn.endsWith(".pdf")) {
-                  if (!exportScoreParts) {
-                        if (layoutMode != LayoutMode::PAGE) {
-                              cs->startCmd();
-                              cs->undo(new ChangeLayoutMode(cs, LayoutMode::PAGE));
-                              cs->doLayout();
-                        }
-                        rv = mscore->savePdf(fn);
-                        }
-                  else {
-                        if (cs->excerpts().size() == 0) {
-                              QList<Excerpt*> exceprts = Excerpt::createAllExcerpt(cs);
-
-                              foreach(Excerpt* e, exceprts) {
-                                    Score* nscore = new Score(e->oscore());
-                                    e->setPartScore(nscore);
-                                    nscore->setName(e->title()); // needed before AddExcerpt
-                                    nscore->style()->set(StyleIdx::createMultiMeasureRests, true);
-                                    cs->startCmd();
-                                    cs->undo(new AddExcerpt(nscore));
-                                    createExcerpt(e);
-                                    cs->endCmd();
-                                    }
-                              }
-                        QList<Score*> scores;
-                        scores.append(cs);
-                        foreach(Excerpt* e, cs->excerpts())
-                              scores.append(e->partScore());
-                        return mscore->savePdf(scores, fn);
-                        }
-                  }
-            else if (fn.endsWith(".png")) {
-                  if (layoutMode != LayoutMode::PAGE) {
-                        cs->startCmd();
-                        cs->undo(new ChangeLayoutMode(cs, LayoutMode::PAGE));
-                        cs->doLayout();
-                        }
-                  rv = mscore->savePng(cs, fn);
-                  }
-            else if (fn.endsWith(".svg")) {
-                  if (layoutMode != LayoutMode::PAGE) {
-                        cs->startCmd();
-                        cs->undo(new ChangeLayoutMode(cs, LayoutMode::PAGE));
-                        cs->doLayout();
-                        }
-                  rv = mscore->saveSvg(cs, fn);
-                  }
-#ifdef HAS_AUDIOFILE
-            else if (fn.endsWith(".wav") || fn.endsWith(".ogg") || fn.endsWith(".flac"))
-                  return mscore->saveAudio(cs, fn);
-#endif
-#ifdef USE_LAME
-            else if (fn.endsWith(".mp3"))
-                  return mscore->saveMp3(cs, fn);
-#endif
-            else if (fn.endsWith(".spos")) {
-                  if (layoutMode != LayoutMode::PAGE) {
-                        cs->startCmd();
-                        cs->undo(new ChangeLayoutMode(cs, LayoutMode::PAGE));
-                        cs->doLayout();
-                        }
-                  rv = savePositions(cs, fn, true);
-                  }
-            else if (fn.endsWith(".mpos")) {
-                  if (layoutMode != LayoutMode::PAGE) {
-                        cs->startCmd();
-                        cs->undo(new ChangeLayoutMode(cs, LayoutMode::PAGE));
-                        cs->doLayout();
-                        }
-                  rv = savePositions(cs, fn, false);
-                  }
-            else if (fn.endsWith(".mlog"))
-                  return cs->sanityCheck(fn);
-            else {
-                  qDebug("dont know how to convert to %s", qPrintable(outFileName));
-                  return false;
-                  }
-            if (layoutMode != cs->layoutMode())
-                  cs->endCmd(true);       // rollback
+            return convert(cs, outFileName);
             }
-      return rv;
+      return true;
       }
 
 //---------------------------------------------------------
@@ -3178,7 +3427,7 @@ void MuseScore::writeSessionFile(bool cleanExit)
 
       QDir dir;
       dir.mkpath(dataPath);
-      QFile f(dataPath + "/session");
+      QSaveFile f(dataPath + "/session");
       if (!f.open(QIODevice::WriteOnly)) {
             qDebug("cannot create session file <%s>", qPrintable(f.fileName()));
             return;
@@ -3204,7 +3453,8 @@ void MuseScore::writeSessionFile(bool cleanExit)
                   path = score->importedFilePath();
                   }
 
-            if (cleanExit || score->tmpName().isEmpty()) {
+            // an empty temporary file has not been written yet
+            if (cleanExit || score->tmpName().isEmpty() || QFileInfo(score->tmpName()).size() == 0) {
                   xml.tag("path", path);
                   }
             else {
@@ -3258,7 +3508,8 @@ void MuseScore::writeSessionFile(bool cleanExit)
       xml.tag("tab", tab);
       xml.tag("idx", idx);
       xml.etag();
-      f.close();
+      if (!f.commit())
+            qDebug("cannot write session file <%s>", qPrintable(f.fileName()));
       if (cleanExit) {
             // TODO: remove all temporary session backup files
             }
@@ -3279,22 +3530,85 @@ void MuseScore::removeSessionFile()
             }
       }
 
+//---------------------------------------------------------
+//   writeAutoSave
+//    compress and write an autosave snapshot; runs on a
+//    worker thread. The snapshot is written to a temporary
+//    name and renamed to path on success, so path always
+//    holds a complete score. If the session file does not
+//    refer to path yet, it is updated afterwards.
+//---------------------------------------------------------
+
+static bool writeAutoSave(const QString& path, const MsczSnapshot& snapshot, bool updateSession)
+      {
+      QSaveFile f(path);
+      if (!f.open(QIODevice::WriteOnly)) {
+            qDebug("autosave: cannot open <%s>", qPrintable(path));
+            return false;
+            }
+      try {
+            Score::writeMscz(&f, snapshot);
+            }
+      catch (QString s) {
+            qDebug("autosave: %s", qPrintable(s));
+            f.cancelWriting();
+            return false;
+            }
+      f.flush();
+#ifdef Q_OS_UNIX
+      fsync(f.handle());
+#endif
+      if (!f.commit()) {
+            qDebug("autosave: cannot write <%s>", qPrintable(path));
+            return false;
+            }
+      if (updateSession)
+            QMetaObject::invokeMethod(mscore, "autoSaveWritten", Qt::QueuedConnection, Q_ARG(QString, path));
+      return true;
+      }
+
+//---------------------------------------------------------
+//   autoSaveWritten
+//    the first autosave of a score was written to path
+//---------------------------------------------------------
+
+void MuseScore::autoSaveWritten(const QString& path)
+      {
+      if (QFileInfo(path).size() == 0)
+            return;           // removed meanwhile, score was saved or closed
+      for (Score* s : scoreList) {
+            if (s->tmpName() == path) {
+                  writeSessionFile(false);
+                  return;
+                  }
+            }
+      }
+
+//---------------------------------------------------------
+//   waitForAutoSave
+//    wait until all autosave files are written
+//---------------------------------------------------------
+
+void MuseScore::waitForAutoSave()
+      {
+      for (QFuture<bool>& job : autoSaveJobs)
+            job.waitForFinished();
+      autoSaveJobs.clear();
+      }
+
 //---------------------------------------------------------
 //   autoSaveTimerTimeout
+//    only a snapshot of the score is taken here, it is
+//    compressed and written by a worker thread; autosaves
+//    have no thumbnail
 //---------------------------------------------------------
 
 void MuseScore::autoSaveTimerTimeout()
       {
-      bool sessionChanged = false;
       foreach (Score* s, scoreList) {
             if (s->autosaveDirty()) {
                   QString tmp = s->tmpName();
-                  if (!tmp.isEmpty()) {
-                        QFileInfo fi(tmp);
-                        // TODO: cannot catch exeption here:
-                        s->saveCompressedFile(fi, false);
-                        }
-                  else {
+                  if (tmp.isEmpty()) {
                         QDir dir;
                         dir.mkpath(dataPath);
                         QTemporaryFile tf(dataPath + "/scXXXXXX.mscz");
@@ -3303,17 +3617,19 @@ void MuseScore::autoSaveTimerTimeout()
                               qDebug("autoSaveTimerTimeout(): create temporary file failed");
                               return;
                               }
-                        s->setTmpName(tf.fileName());
-                        QFileInfo info(tf.fileName());
-                        s->saveCompressedFile(&tf, info, false);
                         tf.close();
-                        sessionChanged = true;
+                        tmp = tf.fileName();
+                        s->setTmpName(tmp);
                         }
+                  else if (autoSaveJobs.contains(tmp) && !autoSaveJobs[tmp].isFinished())
+                        continue;         // previous autosave still running, try again next time
+                  QFileInfo fi(tmp);
+                  bool first = fi.size() == 0;    // not yet in the session file
+                  MsczSnapshot snapshot = s->msczSnapshot(fi, false, false);
+                  autoSaveJobs[tmp] = QtConcurrent::run(writeAutoSave, tmp, snapshot, first);
                   s->setAutosaveDirty(false);
                   }
             }
-      if (sessionChanged)
-            writeSessionFile(false);
       if (preferences.autoSave) {
             int t = preferences.autoSaveTime * 60 * 1000;
             autoSaveTimer->start(t);
@@ -4640,6 +4956,9 @@ int main(int argc, char* av[])
       parser.addOption(QCommandLineOption({"I", "dump-midi-in"}, "Dump midi input"));
       parser.addOption(QCommandLineOption({"O", "dump-midi-out"}, "Dump midi output"));
       parser.addOption(QCommandLineOption({"o", "export-to"}, "Export to 'file'; format depends on file extension", "file"));
+      parser.addOption(QCommandLineOption({"j", "job"}, "Process a conversion job file ('-' for stdin)", "file"));
+      parser.addOption(QCommandLineOption(      "job-report", "Write a json report of the job file conversions to 'file'", "file"));
+      parser.addOption(QCommandLineOption(      "job-workers", "Distribute the jobs of a job file to 'n' worker processes", "n"));
       parser.addOption(QCommandLineOption({"r", "image-resolution"}, "Set output resolution for image export", "dpi"));
       parser.addOption(QCommandLineOption({"T", "trim-image"}, "Trim exported image with specified margin (in pixels)", "margin"));
       parser.addOption(QCommandLineOption({"x", "gui-scaling"}, "Set scaling factor for GUI elements", "factor"));
@@ -4655,6 +4974,13 @@ int main(int argc, char* av[])
       parser.addOption(QCommandLineOption({"M", "midi-operations"}, "Specify MIDI import operations file", "file"));
       parser.addOption(QCommandLineOption({"w", "no-webview"}, "No web view in start center"));
       parser.addOption(QCommandLineOption({"P", "export-score-parts"}, "used with -o <file>.pdf, export score + parts"));
+      parser.addOption(QCommandLineOption(      "no-musicxml-validation", "used with -o or -j, do not validate imported MusicXML files against the schema"));
+#ifdef USE_TRACE
+      parser.addOption(QCommandLineOption(      "trace", "Write a Chrome trace of layout, playback and file timings to 'file'", "file"));
+#endif
+      parser.addOption(QCommandLineOption(      "audio-load", "Print audio callback load and xrun statistics on exit"));
+      parser.addOption(QCommandLineOption(      "memory-report", "Print the memory used by the elements of the scores by type and exit"));
+      parser.addOption(QCommandLineOption(      "sample-memory", "Read at most 'MB' of sample data into memory, stream the rest from the sound files", "MB"));
 
       parser.addPositionalArgument("scorefiles", "The files to open", "[scorefile...]");
 
@@ -4676,6 +5002,14 @@ int main(int argc, char* av[])
             }
       startWithNewScore = parser.isSet("n");
       externalIcons = parser.isSet("i");
+#ifdef USE_TRACE
+      if (parser.isSet("trace")) {
+            traceFile = parser.value("trace");
+            if (traceFile.isEmpty())
+                  parser.showHelp(EXIT_FAILURE);
+            Trace::start(traceFile);
+            }
+#endif
       midiInputTrace = parser.isSet("I");
       midiOutputTrace = parser.isSet("O");
       if ((converterMode = parser.isSet("o"))) {
@@ -4684,6 +5018,24 @@ int main(int argc, char* av[])
             if (outFileName.isEmpty())
                   parser.showHelp(EXIT_FAILURE);
             }
+      if (parser.isSet("j")) {
+            converterMode = true;
+            MScore::noGui = true;
+            jobFile = parser.value("j");
+            if (jobFile.isEmpty() || parser.isSet("o"))
+                  parser.showHelp(EXIT_FAILURE);
+            if (parser.isSet("job-report")) {
+                  jobReportFile = parser.value("job-report");
+                  if (jobReportFile.isEmpty())
+                        parser.showHelp(EXIT_FAILURE);
+                  }
+            if (parser.isSet("job-workers")) {
+                  bool ok;
+                  jobWorkers = parser.value("job-workers").toInt(&ok);
+                  if (!ok || jobWorkers < 1)
+                        parser.showHelp(EXIT_FAILURE);
+                  }
+            }
       if ((pluginMode = parser.isSet("p"))) {
             MScore::noGui = true;
             pluginName = parser.value("p");
@@ -4736,16 +5088,29 @@ int main(int argc, char* av[])
             preferences.midiImportOperations.setOperationsFile(temp);
             }
       noWebView = parser.isSet("w");
+      audioLoadReport = parser.isSet("audio-load");
+      if ((memoryReport = parser.isSet("memory-report")))
+            MScore::noGui = true;
+      if (parser.isSet("sample-memory")) {
+            bool ok;
+            qint64 mb = parser.value("sample-memory").toLongLong(&ok);
+            if (!ok || mb < 0)
+                  parser.showHelp(EXIT_FAILURE);
+            SampleMemory::budget() = mb * 1024 * 1024;
+            }
       exportScoreParts = parser.isSet("export-score-parts");
       if (exportScoreParts && !converterMode)
             parser.showHelp(EXIT_FAILURE);
+      noMusicXmlValidation = parser.isSet("no-musicxml-validation");
+      if (noMusicXmlValidation && !converterMode)
+            parser.showHelp(EXIT_FAILURE);
 
       QStringList argv = parser.positionalArguments();
 
       mscoreGlobalShare = getSharePath();
       iconPath = externalIcons ? mscoreGlobalShare + QString("icons/") :  QString(":/data/icons/");
 
-      if (!converterMode && !pluginMode) {
+      if (!converterMode && !pluginMode && !memoryReport) {
             if (!argv.isEmpty()) {
                   int ok = true;
                   foreach(QString message, argv) {
@@ -4842,6 +5207,8 @@ int main(int argc, char* av[])
 
       preferences.readDefaultStyle();
 
+      if (noMusicXmlValidation)
+            preferences.musicxmlImportValidate = false;
       if (converterDpi == 0)
             converterDpi = preferences.pngResolution;
 
@@ -4862,7 +5229,7 @@ int main(int argc, char* av[])
             qApp->processEvents();
             }
 
-      if (!converterMode && !pluginMode) {
+      if (!converterMode && !pluginMode && !memoryReport) {
             struct PaletteItem {
                   QPalette::ColorRole role;
                   const char* name;
@@ -5033,8 +5400,11 @@ int main(int argc, char* av[])
             // see issue #28706: Hangup in converter mode with MusicXML source
             qApp->processEvents();
 #endif
-            loadScores(argv);
-            exit(processNonGui() ? 0 : EXIT_FAILURE);
+            if (jobFile.isEmpty())        // a job file names its own scores
+                  loadScores(argv);
+            bool ok = processNonGui();
+            Trace::stop();
+            exit(ok ? 0 : EXIT_FAILURE);
             }
       else {
             mscore->readSettings();
@@ -5105,6 +5475,10 @@ int main(int argc, char* av[])
 
       mscore->showPlayPanel(preferences.showPlayPanel);
 
-      return qApp->exec();
+      int rv = qApp->exec();
+      if (audioLoadReport && seq)
+            fputs(qPrintable(seq->loadReport()), stderr);
+      Trace::stop();
+      return rv;
       }
 
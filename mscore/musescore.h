@@ -303,6 +303,7 @@ class MuseScore : public QMainWindow, public MuseScoreCore {
       void removeMenuEntry(PluginDescription*);
 
       QTimer* autoSaveTimer;
+      QMap<QString, QFuture<bool>> autoSaveJobs;     // tmp file name -> running autosave
       QList<QAction*> qmlPluginActions;
       QList<QAction*> pluginActions;
       QSignalMapper* pluginMapper        { 0 };
@@ -417,10 +418,12 @@ class MuseScore : public QMainWindow, public MuseScoreCore {
       void addRecentScore(const QString& scorePath);
 
       void updateNewWizard();
+      void waitForAutoSave();
 
    private slots:
       void cmd(QAction* a, const QString& cmd);
       void autoSaveTimerTimeout();
+      void autoSaveWritten(const QString& path);
       void helpBrowser1() const;
       void about();
       void aboutQt();
@@ -513,6 +516,7 @@ class MuseScore : public QMainWindow, public MuseScoreCore {
       double getMag(ScoreView*) const;
       void setMag(double);
       bool noScore() const { return scoreList.isEmpty(); }
+      const QList<Score*>& scores() const { return scoreList; }
 
       TextTools* textTools();
       void showDrumTools(const Drumset*, Staff*);
@@ -100,6 +100,10 @@ Navigator::Navigator(NScrollArea* sa, QWidget* parent)
       scrollArea->setWidgetResizable(true);
       _cv            = 0;
       viewRect       = new ViewRect(this);
+      renderTimer    = new QTimer(this);
+      renderTimer->setSingleShot(true);
+      renderTimer->setInterval(0);
+      connect(renderTimer, SIGNAL(timeout()), SLOT(renderPages()));
       setSizePolicy(QSizePolicy::Ignored, QSizePolicy::Ignored);
       sa->setWidget(this);
       sa->setWidgetResizable(false);
@@ -128,9 +132,11 @@ void Navigator::setScoreView(ScoreView* v)
             disconnect(_cv, SIGNAL(viewRectChanged()), this, SLOT(updateViewRect()));
             }
       _cv = QPointer<ScoreView>(v);
+      pageImages.clear();
       if (v) {
             _score  = v->score();
             rescale();
+            updatePageImages();
             connect(this, SIGNAL(viewRectMoved(const QRectF&)), v, SLOT(setViewRect(const QRectF&)));
             connect(_cv,  SIGNAL(viewRectChanged()), this, SLOT(updateViewRect()));
             rescale();
@@ -152,7 +158,9 @@ void Navigator::setScore(Score* v)
       {
       _cv    = 0;
       _score = v;
+      pageImages.clear();
       rescale();
+      updatePageImages();
       updateViewRect();
       update();
       }
@@ -175,6 +183,12 @@ void Navigator::rescale()
       qreal m  = height() / scoreHeight;
 
       setFixedWidth(int(scoreWidth * m));
+      if (m != matrix.m11()) {
+            // page images are shown scaled until they are rendered again
+            for (PageImage& pi : pageImages)
+                  pi.dirty = true;
+            renderTimer->start();
+            }
       matrix = QTransform(m, 0, 0, m, 0, 0);
       }
 
@@ -280,6 +294,152 @@ static void paintElement(void* data, Element* e)
       p->translate(-pos);
       }
 
+//---------------------------------------------------------
+//   pageSignature
+//    changes if the systems or measures of page are
+//    moved, added or removed
+//---------------------------------------------------------
+
+static uint pageSignature(Page* page)
+      {
+      uint h = qHash(page->no() + page->score()->pageNumberOffset());
+      h = h * 31 + qHash(page->pos().x());
+      h = h * 31 + qHash(page->width());
+      for (System* s : *page->systems()) {
+            h = h * 31 + qHash(s);
+            h = h * 31 + qHash(s->pos().y());
+            for (MeasureBase* m : s->measures()) {
+                  h = h * 31 + qHash(m);
+                  h = h * 31 + qHash(m->pos().x());
+                  h = h * 31 + qHash(m->width());
+                  }
+            }
+      return h;
+      }
+
+//---------------------------------------------------------
+//   pageContains
+//    return true if page shows measures between stick
+//    and etick
+//---------------------------------------------------------
+
+static bool pageContains(Page* page, int stick, int etick)
+      {
+      const QList<System*>* sl = page->systems();
+      if (sl->isEmpty() || sl->front()->measures().isEmpty() || sl->back()->measures().isEmpty())
+            return false;
+      int t1 = sl->front()->measures().front()->tick();
+      int t2 = sl->back()->measures().back()->endTick();
+      return t1 <= etick && t2 >= stick;
+      }
+
+//---------------------------------------------------------
+//   updatePageImages
+//    After a layout, mark the images of pages which show
+//    the laid out measures or whose systems have changed.
+//    The old images are shown until renderPages() has
+//    rendered them again.
+//---------------------------------------------------------
+
+void Navigator::updatePageImages()
+      {
+      if (!_score) {
+            pageImages.clear();
+            return;
+            }
+      int stick = _score->layoutStartTick();
+      int etick = _score->layoutEndTick();
+      if (stick != -1) {
+            // spanners starting or ending in the range are
+            // laid out again
+            for (const ::Interval<Spanner*>& i : _score->spannerMap().findOverlapping(stick, etick)) {
+                  stick = qMin(stick, i.start);
+                  etick = qMax(etick, i.stop);
+                  }
+            }
+      const QList<Page*>& pl = _score->pages();
+      while (pageImages.size() > pl.size())
+            pageImages.removeLast();
+      bool dirty = false;
+      for (int i = 0; i < pl.size(); ++i) {
+            Page* page = pl[i];
+            uint signature = pageSignature(page);
+            if (i == pageImages.size())
+                  pageImages.append({ QPixmap(), signature, true });
+            PageImage& pi = pageImages[i];
+            if (pi.signature != signature || stick == -1 || pageContains(page, stick, etick))
+                  pi.dirty = true;
+            pi.signature = signature;
+            dirty = dirty || pi.dirty;
+            }
+      if (dirty)
+            renderTimer->start();
+      }
+
+//---------------------------------------------------------
+//   renderPage
+//---------------------------------------------------------
+
+void Navigator::renderPage(int idx)
+      {
+      Page* page = _score->pages().at(idx);
+      qreal dpr  = devicePixelRatio();
+      QSize size = matrix.mapRect(page->bbox()).size().toSize().expandedTo(QSize(1, 1));
+      QPixmap pm(size * dpr);
+      pm.setDevicePixelRatio(dpr);
+      pm.fill(Qt::white);
+
+      QPainter p(&pm);
+      p.setTransform(matrix);
+      foreach(System* s, *page->systems()) {
+            foreach(MeasureBase* m, s->measures())
+                  m->scanElements(&p, paintElement, false);
+            }
+      page->scanElements(&p, paintElement, false);
+      if (page->score()->layoutMode() == LayoutMode::PAGE) {
+            p.setFont(QFont("FreeSans", 400));  // !!
+            p.setPen(MScore::layoutBreakColor);
+            p.drawText(page->bbox(), Qt::AlignCenter, QString("%1").arg(page->no() + 1 + _score->pageNumberOffset()));
+            }
+      p.end();
+
+      PageImage& pi = pageImages[idx];
+      pi.pixmap = pm;
+      pi.dirty  = false;
+      update(matrix.mapRect(page->abbox().translated(page->pos())).toAlignedRect());
+      }
+
+//---------------------------------------------------------
+//   renderPages
+//    render dirty page images in slices of some ms,
+//    visible pages first
+//---------------------------------------------------------
+
+void Navigator::renderPages()
+      {
+      if (!_score || !isVisible())
+            return;
+      if (pageImages.size() != _score->pages().size())
+            updatePageImages();
+      QElapsedTimer timer;
+      timer.start();
+      QRectF vr = matrix.inverted().mapRect(QRectF(visibleRegion().boundingRect()));
+      for (int pass = 0; pass < 2; ++pass) {
+            for (int i = 0; i < pageImages.size(); ++i) {
+                  if (!pageImages[i].dirty)
+                        continue;
+                  Page* page = _score->pages().at(i);
+                  if (pass == 0 && !vr.intersects(page->abbox().translated(page->pos())))
+                        continue;
+                  renderPage(i);
+                  if (timer.elapsed() > 20) {
+                        renderTimer->start();
+                        return;
+                        }
+                  }
+            }
+      }
+
 //---------------------------------------------------------
 //   layoutChanged
 //---------------------------------------------------------
@@ -288,9 +448,46 @@ void Navigator::layoutChanged()
       {
       if (_score && !_score->pages().isEmpty())
             rescale();
+      updatePageImages();
       update();
       }
 
+//---------------------------------------------------------
+//   dataChanged
+//    elements in the canvas rectangle r were redrawn
+//    without a layout, e.g. after a selection or colour
+//    change
+//---------------------------------------------------------
+
+void Navigator::dataChanged(const QRectF& r)
+      {
+      if (!_score || pageImages.size() != _score->pages().size())
+            return;
+      bool dirty = false;
+      const QList<Page*>& pl = _score->pages();
+      for (int i = 0; i < pl.size(); ++i) {
+            Page* page = pl[i];
+            if (!pageImages[i].dirty && r.intersects(page->abbox().translated(page->pos()))) {
+                  pageImages[i].dirty = true;
+                  dirty = true;
+                  }
+            }
+      if (dirty)
+            renderTimer->start();
+      }
+
+//---------------------------------------------------------
+//   updateAll
+//---------------------------------------------------------
+
+void Navigator::updateAll()
+      {
+      for (PageImage& pi : pageImages)
+            pi.dirty = true;
+      if (!pageImages.isEmpty())
+            renderTimer->start();
+      }
+
 //---------------------------------------------------------
 //   paintEvent
 //---------------------------------------------------------
@@ -306,31 +503,31 @@ void Navigator::paintEvent(QPaintEvent* ev)
       if (!_score)
             return;
 
-      p.setTransform(matrix);
       QRectF fr = matrix.inverted().mapRect(QRectF(r));
 
-      foreach (Page* page, _score->pages()) {
-            QPointF pos(page->pos());
-            QRectF pr(page->abbox().translated(pos));
+      // pages are drawn from the images made by renderPages()
+      const QList<Page*>& pl = _score->pages();
+      for (int i = 0; i < pl.size(); ++i) {
+            Page* page = pl[i];
+            QRectF pr(page->abbox().translated(page->pos()));
             if (pr.right() < fr.left())
                   continue;
             if (pr.left() > fr.right())
                   break;
-
-            p.fillRect(pr, Qt::white);
-            p.translate(pos);
-            foreach(System* s, *page->systems()) {
-                  foreach(MeasureBase* m, s->measures())
-                        m->scanElements(&p, paintElement, false);
-                  }
-            page->scanElements(&p, paintElement, false);
-            if (page->score()->layoutMode() == LayoutMode::PAGE) {
-                  p.setFont(QFont("FreeSans", 400));  // !!
-                  p.setPen(MScore::layoutBreakColor);
-                  p.drawText(page->bbox(), Qt::AlignCenter, QString("%1").arg(page->no() + 1 + _score->pageNumberOffset()));
+            QRectF dr = matrix.mapRect(pr);
+            if (i < pageImages.size() && !pageImages[i].pixmap.isNull()) {
+                  const QPixmap& pm = pageImages[i].pixmap;
+                  p.drawPixmap(dr, pm, QRectF(QPointF(), pm.size()));
                   }
-            p.translate(-pos);
+            else
+                  p.fillRect(dr, Qt::white);
             }
+      // renderPages() does nothing while the navigator is hidden
+      bool dirty = pageImages.size() != pl.size();
+      for (const PageImage& pi : pageImages)
+            dirty = dirty || pi.dirty;
+      if (dirty && !renderTimer->isActive())
+            renderTimer->start();
       }
 }
 
@@ -71,16 +71,32 @@ class Navigator : public QWidget {
       QPoint startMove;
       QTransform matrix;
 
+      // miniature of a page, rendered in idle time
+      struct PageImage {
+            QPixmap pixmap;
+            uint signature;
+            bool dirty;
+            };
+      QList<PageImage> pageImages;
+      QTimer* renderTimer;
+
       void rescale();
+      void updatePageImages();
+      void renderPage(int idx);
 
       virtual void paintEvent(QPaintEvent*);
       virtual void mousePressEvent(QMouseEvent*);
       virtual void mouseMoveEvent(QMouseEvent*);
       virtual void resizeEvent(QResizeEvent*);
 
+   private slots:
+      void renderPages();
+
    public slots:
       void updateViewRect();
       void layoutChanged();
+      void dataChanged(const QRectF&);
+      void updateAll();
 
    signals:
       void viewRectMoved(const QRectF&);
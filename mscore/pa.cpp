@@ -42,8 +42,10 @@ static PaStream* stream;
 //---------------------------------------------------------
 
 int paCallback(const void*, void* out, long unsigned frames,
-   const PaStreamCallbackTimeInfo*, PaStreamCallbackFlags, void *)
+   const PaStreamCallbackTimeInfo*, PaStreamCallbackFlags flags, void* data)
       {
+      if (flags & (paOutputUnderflow | paOutputOverflow))
+            static_cast<Portaudio*>(data)->addXrun();
       seq->process((unsigned)frames, (float*)out);
       return 0;
       }
@@ -160,6 +160,7 @@ void Preferences::init()
 
       musicxmlImportLayout     = true;
       musicxmlImportBreaks     = true;
+      musicxmlImportValidate   = true;
       musicxmlExportLayout     = true;
       musicxmlExportBreaks     = MusicxmlExportBreaks::ALL;
 
@@ -293,6 +294,7 @@ void Preferences::write()
 
       s.setValue("musicxmlImportLayout",  musicxmlImportLayout);
       s.setValue("musicxmlImportBreaks",  musicxmlImportBreaks);
+      s.setValue("musicxmlImportValidate", musicxmlImportValidate);
       s.setValue("musicxmlExportLayout",  musicxmlExportLayout);
       switch(musicxmlExportBreaks) {
             case MusicxmlExportBreaks::ALL:     s.setValue("musicxmlExportBreaks", "all"); break;
@@ -442,6 +444,7 @@ void Preferences::read()
 
       musicxmlImportLayout     = s.value("musicxmlImportLayout", musicxmlImportLayout).toBool();
       musicxmlImportBreaks     = s.value("musicxmlImportBreaks", musicxmlImportBreaks).toBool();
+      musicxmlImportValidate   = s.value("musicxmlImportValidate", musicxmlImportValidate).toBool();
       musicxmlExportLayout     = s.value("musicxmlExportLayout", musicxmlExportLayout).toBool();
       QString br(s.value("musicxmlExportBreaks", "all").toString());
       if (br == "all")
@@ -839,6 +842,7 @@ void PreferenceDialog::updateValues()
 
       importLayout->setChecked(prefs.musicxmlImportLayout);
       importBreaks->setChecked(prefs.musicxmlImportBreaks);
+      importValidate->setChecked(prefs.musicxmlImportValidate);
       exportLayout->setChecked(prefs.musicxmlExportLayout);
       switch(prefs.musicxmlExportBreaks) {
             case MusicxmlExportBreaks::ALL:     exportAllBreaks->setChecked(true); break;
@@ -1384,6 +1388,7 @@ void PreferenceDialog::apply()
 
       prefs.musicxmlImportLayout  = importLayout->isChecked();
       prefs.musicxmlImportBreaks  = importBreaks->isChecked();
+      prefs.musicxmlImportValidate = importValidate->isChecked();
       prefs.musicxmlExportLayout  = exportLayout->isChecked();
       if (exportAllBreaks->isChecked())
             prefs.musicxmlExportBreaks = MusicxmlExportBreaks::ALL;
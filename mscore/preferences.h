@@ -128,6 +128,7 @@ struct Preferences {
 
       bool musicxmlImportLayout;
       bool musicxmlImportBreaks;
+      bool musicxmlImportValidate;
       bool musicxmlExportLayout;
       MusicxmlExportBreaks musicxmlExportBreaks;
 
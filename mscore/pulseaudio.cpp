@@ -35,6 +35,7 @@ class PulseAudio : public Driver {
       pthread_t thread;
 
       static void paCallback(pa_stream* s, size_t len, void* data);
+      static void underflowCallback(pa_stream* s, void* data);
       static void* paLoop(void*);
 
    public:
@@ -49,6 +50,15 @@ class PulseAudio : public Driver {
       virtual void startTransport()  { state = Transport::PLAY; }
       };
 
+//---------------------------------------------------------
+//   underflowCallback
+//---------------------------------------------------------
+
+void PulseAudio::underflowCallback(pa_stream*, void* data)
+      {
+      static_cast<PulseAudio*>(data)->addXrun();
+      }
+
 //---------------------------------------------------------
 //   paCallback
 //---------------------------------------------------------
@@ -144,6 +154,7 @@ bool PulseAudio::init(bool)
             return false;
             }
       pa_stream_set_write_callback(playstream, paCallback, this);
+      pa_stream_set_underflow_callback(playstream, underflowCallback, this);
 
       bufattr.fragsize  = (uint32_t)-1;
       bufattr.maxlength = FRAMES * 2 * sizeof(float);
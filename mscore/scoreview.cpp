@@ -106,6 +106,9 @@ enum {
 
 static const QEvent::Type CloneDrag = QEvent::Type(QEvent::User + 1);
 
+static const int TILE_SIZE       = 256;               // device pixels
+static const int TILE_CACHE_SIZE = 96 * 1024;         // KB
+
 //---------------------------------------------------------
 //   CloneEvent
 //---------------------------------------------------------
@@ -668,6 +671,8 @@ ScoreView::ScoreView(QWidget* parent)
       _matrix     = QTransform(mag, 0.0, 0.0, mag, 0.0, 0.0);
       imatrix     = _matrix.inverted();
       _magIdx     = preferences.mag == 1.0 ? MagIdx::MAG_100 : MagIdx::MAG_FREE;
+      _tiles.setMaxCost(TILE_CACHE_SIZE);
+      _tileMag    = 0.0;
       focusFrame  = 0;
       dragElement = 0;
       curElement  = 0;
@@ -956,6 +961,7 @@ void ScoreView::setScore(Score* s)
       _score = s;
       if (_score)
             _score->addViewer(this);
+      _tiles.clear();
 
       if (shadowNote == 0) {
             shadowNote = new ShadowNote(_score);
@@ -1315,7 +1321,24 @@ void ScoreView::setForeground(const QColor& color)
 
 void ScoreView::dataChanged(const QRectF& r)
       {
+      invalidateTiles(r);
       update(_matrix.mapRect(r).toRect());  // generate paint event
+      Navigator* nav = mscore->navigator();
+      if (nav && nav->score() == _score)
+            nav->dataChanged(r);
+      }
+
+//---------------------------------------------------------
+//   updateAll
+//---------------------------------------------------------
+
+void ScoreView::updateAll()
+      {
+      _tiles.clear();
+      update();
+      Navigator* nav = mscore->navigator();
+      if (nav && nav->score() == _score)
+            nav->updateAll();
       }
 
 //---------------------------------------------------------
@@ -1879,6 +1902,13 @@ void ScoreView::paint(const QRect& r, QPainter& p)
             drawElements(p, ell);
             }
       else {
+            // debug info is drawn for selected elements only
+            // and should always be up to date
+            bool useTiles = !score()->printing() && !MScore::debugMode;
+            if (_tileMag != _matrix.m11()) {
+                  _tiles.clear();
+                  _tileMag = _matrix.m11();
+                  }
             foreach (Page* page, _score->pages()) {
                   if (!score()->printing())
                         paintPageBorder(p, page);
@@ -1887,12 +1917,16 @@ void ScoreView::paint(const QRect& r, QPainter& p)
                         continue;
                   if (pr.left() > fr.right())
                         break;
-                  QList<Element*> ell = page->items(fr.translated(-page->pos()));
-                  qStableSort(ell.begin(), ell.end(), elementLessThan);
-                  QPointF pos(page->pos());
-                  p.translate(pos);
-                  drawElements(p, ell);
-                  p.translate(-pos);
+                  if (useTiles)
+                        drawPageTiles(p, page, r);
+                  else {
+                        QList<Element*> ell = page->items(fr.translated(-page->pos()));
+                        qStableSort(ell.begin(), ell.end(), elementLessThan);
+                        QPointF pos(page->pos());
+                        p.translate(pos);
+                        drawElements(p, ell);
+                        p.translate(-pos);
+                        }
                   r1 -= _matrix.mapRect(pr).toAlignedRect();
                   }
             }
@@ -2298,6 +2332,83 @@ static void drawDebugInfo(QPainter& p, const Element* _e)
             }
       }
 
+//---------------------------------------------------------
+//   tileKey
+//---------------------------------------------------------
+
+static quint64 tileKey(int page, int x, int y)
+      {
+      return (quint64(page) << 40) | (quint64(x & 0xfffff) << 20) | quint64(y & 0xfffff);
+      }
+
+//---------------------------------------------------------
+//   drawPageTiles
+//    Draw the part of page which is inside the device
+//    rectangle r from rendered tiles. A tile is rendered
+//    once and reused for scrolling until its area changes
+//    or the zoom level changes. The page origin is aligned
+//    to device pixels.
+//---------------------------------------------------------
+
+void ScoreView::drawPageTiles(QPainter& p, Page* page, const QRect& r)
+      {
+      const qreal mag = _matrix.m11();
+      const QPoint po = _matrix.map(page->pos()).toPoint();
+      QRect pr = QRect(QPoint(), (page->bbox().size() * mag).toSize() + QSize(1, 1));
+      QRect dr = r.translated(-po) & pr;
+      if (dr.isEmpty())
+            return;
+
+      const int ts = qCeil(TILE_SIZE * devicePixelRatio());
+      p.save();
+      p.setWorldMatrixEnabled(false);
+      for (int ty = dr.top() / TILE_SIZE; ty <= dr.bottom() / TILE_SIZE; ++ty) {
+            for (int tx = dr.left() / TILE_SIZE; tx <= dr.right() / TILE_SIZE; ++tx) {
+                  quint64 key = tileKey(page->no(), tx, ty);
+                  QPixmap* pm = _tiles.object(key);
+                  if (!pm) {
+                        pm = new QPixmap(ts, ts);
+                        pm->setDevicePixelRatio(devicePixelRatio());
+                        pm->fill(Qt::transparent);
+                        QPainter tp(pm);
+                        tp.setRenderHints(p.renderHints());
+                        tp.setTransform(QTransform(mag, 0.0, 0.0, mag, -tx * TILE_SIZE, -ty * TILE_SIZE));
+                        QRectF tr(tx * TILE_SIZE / mag, ty * TILE_SIZE / mag, TILE_SIZE / mag, TILE_SIZE / mag);
+                        QList<Element*> ell = page->items(tr);
+                        qStableSort(ell.begin(), ell.end(), elementLessThan);
+                        drawElements(tp, ell);
+                        tp.end();
+                        _tiles.insert(key, pm, ts * ts * 4 / 1024);
+                        }
+                  p.drawPixmap(po + QPoint(tx * TILE_SIZE, ty * TILE_SIZE), *pm);
+                  }
+            }
+      p.restore();
+      }
+
+//---------------------------------------------------------
+//   invalidateTiles
+//    remove all tiles which intersect the canvas
+//    rectangle r
+//---------------------------------------------------------
+
+void ScoreView::invalidateTiles(const QRectF& r)
+      {
+      if (_tiles.isEmpty() || !_score || _score->layoutMode() == LayoutMode::LINE)
+            return;
+      const qreal mag = _matrix.m11();
+      foreach (Page* page, _score->pages()) {
+            QRectF pr = r.translated(-page->pos()) & page->bbox();
+            if (pr.isEmpty())
+                  continue;
+            QRect dr = QRectF(pr.topLeft() * mag, pr.size() * mag).toAlignedRect();
+            for (int ty = dr.top() / TILE_SIZE; ty <= dr.bottom() / TILE_SIZE; ++ty) {
+                  for (int tx = dr.left() / TILE_SIZE; tx <= dr.right() / TILE_SIZE; ++tx)
+                        _tiles.remove(tileKey(page->no(), tx, ty));
+                  }
+            }
+      }
+
 //---------------------------------------------------------
 //   drawElements
 //---------------------------------------------------------
@@ -5553,6 +5664,7 @@ void ScoreView::gotoMeasure(Measure* measure)
 
 void ScoreView::layoutChanged()
       {
+      _tiles.clear();
       if (mscore->navigator())
             mscore->navigator()->layoutChanged();
       _curLoopIn->move(_score->pos(POS::LEFT));
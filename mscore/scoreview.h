@@ -184,8 +184,15 @@ class ScoreView : public QWidget, public MuseScoreView {
       QPixmap* _bgPixmap;
       QPixmap* _fgPixmap;
 
+      // rendered page tiles keyed by page number and tile
+      // position, valid for zoom level _tileMag
+      QCache<quint64, QPixmap> _tiles;
+      qreal _tileMag;
+
       virtual void paintEvent(QPaintEvent*);
       void paint(const QRect&, QPainter&);
+      void drawPageTiles(QPainter& p, Page* page, const QRect& r);
+      void invalidateTiles(const QRectF&);
 
       void objectPopup(const QPoint&, Element*);
       void measurePopup(const QPoint&, Measure*);
@@ -425,7 +432,7 @@ class ScoreView : public QWidget, public MuseScoreView {
 
       virtual void layoutChanged();
       virtual void dataChanged(const QRectF&);
-      virtual void updateAll()    { update(); }
+      virtual void updateAll();
       virtual void adjustCanvasPosition(const Element* el, bool playBack);
       virtual void setCursor(const QCursor& c) { QWidget::setCursor(c); }
       virtual QCursor cursor() const { return QWidget::cursor(); }
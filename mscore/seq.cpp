@@ -23,6 +23,7 @@
 #include "musescore.h"
 
 #include "synthesizer/msynthesizer.h"
+#include "synthesizer/samplememory.h"
 #include "libmscore/slur.h"
 #include "libmscore/tie.h"
 #include "libmscore/score.h"
@@ -40,6 +41,7 @@
 #include "libmscore/utils.h"
 #include "libmscore/repeatlist.h"
 #include "libmscore/audio.h"
+#include "libmscore/trace.h"
 #include "synthcontrol.h"
 #include "pianoroll.h"
 #include "pianotools.h"
@@ -137,6 +139,8 @@ Seq::Seq()
       {
       running         = false;
       playlistChanged = false;
+      changedStartTick = -1;
+      changedEndTick   = -1;
       cs              = 0;
       cv              = 0;
       tackRest        = 0;
@@ -147,6 +151,8 @@ Seq::Seq()
       state    = Transport::STOP;
       oggInit  = false;
       _driver  = 0;
+      _synti   = 0;
+      _driverXruns = 0;
       playPos  = events.cbegin();
 
       playTime  = 0;
@@ -211,7 +217,8 @@ void Seq::setScoreView(ScoreView* v)
       if (!heartBeatTimer->isActive())
             heartBeatTimer->start(20);    // msec
 
-      playlistChanged = true;
+      playlistChanged  = true;
+      changedStartTick = -1;
       _synti->reset();
       if (cs) {
             initInstruments();
@@ -245,6 +252,7 @@ void Seq::exit()
             if (MScore::debugMode)
                   qDebug("Stop I/O");
             stopWait();
+            _driverXruns += _driver->xruns();
             delete _driver;
             _driver = 0;
             }
@@ -638,6 +646,8 @@ void Seq::addCountInClicks()
 
 void Seq::process(unsigned n, float* buffer)
       {
+      TRACE_SCOPE("Seq::process");
+      LoadMeter::Timer loadTimer(&_load, n, MScore::sampleRate);
       unsigned frames = n;
       Transport driverState = _driver->getState();
       // Checking for the reposition from JACK Transport
@@ -891,6 +901,43 @@ void Seq::process(unsigned n, float* buffer)
             }
       }
 
+//---------------------------------------------------------
+//   driverXruns
+//    buffers the audio drivers reported as skipped or late
+//---------------------------------------------------------
+
+unsigned Seq::driverXruns() const
+      {
+      return _driverXruns + (_driver ? _driver->xruns() : 0);
+      }
+
+//---------------------------------------------------------
+//   resetLoad
+//---------------------------------------------------------
+
+void Seq::resetLoad()
+      {
+      _load.reset();
+      if (_synti)
+            _synti->resetLoad();
+      }
+
+//---------------------------------------------------------
+//   loadReport
+//    load of the audio callback and its parts, to size
+//    buffers and voice counts for live use
+//---------------------------------------------------------
+
+QString Seq::loadReport()
+      {
+      QString s = _load.report("audio callback");
+      if (_synti)
+            s += _synti->loadReport();
+      s += QString("driver xruns %1, synthesizer xruns %2, sample underruns %3\n")
+         .arg(driverXruns()).arg(_synti ? _synti->xruns() : 0).arg(SampleMemory::underruns());
+      return s;
+      }
+
 //---------------------------------------------------------
 //   initInstruments
 //---------------------------------------------------------
@@ -948,10 +995,12 @@ void Seq::collectEvents()
       //do not collect even while playing
       if (state ==  Transport::PLAY)
             return;
-      events.clear();
 
       mutex.lock();
-      cs->renderMidi(&events);
+      if (!cs->renderMidiRange(&events, changedStartTick, changedEndTick)) {
+            events.clear();
+            cs->renderMidi(&events);
+            }
       endTick = 0;
 
       if (!events.empty()) {
@@ -962,7 +1011,29 @@ void Seq::collectEvents()
       playPos  = events.cbegin();
       mutex.unlock();
 
-      playlistChanged = false;
+      playlistChanged  = false;
+      changedStartTick = INT_MAX;
+      changedEndTick   = -1;
+      }
+
+//---------------------------------------------------------
+//   setPlaylistChanged
+//    collect the range of changed events up to the next
+//    collectEvents()
+//---------------------------------------------------------
+
+void Seq::setPlaylistChanged()
+      {
+      int stick;
+      int etick;
+      cs->playlistRange(&stick, &etick);
+      if (stick == -1)
+            changedStartTick = -1;
+      else if (stick != INT_MAX) {
+            changedStartTick = qMin(changedStartTick, stick);
+            changedEndTick   = qMax(changedEndTick, etick);
+            }
+      playlistChanged = true;
       }
 
 //---------------------------------------------------------
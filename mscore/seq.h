@@ -24,6 +24,7 @@
 #include "libmscore/sequencer.h"
 #include "libmscore/fraction.h"
 #include "synthesizer/event.h"
+#include "synthesizer/loadmeter.h"
 #include "driver.h"
 #include "libmscore/fifo.h"
 #include "libmscore/tempo.h"
@@ -122,12 +123,17 @@ class Seq : public QObject, public Sequencer {
 
       bool oggInit;
       bool playlistChanged;
+      int changedStartTick;               // range of changed events since the last
+      int changedEndTick;                 // collectEvents(), -1: render all
 
       SeqMsgFifo toSeq;
       SeqMsgFifo fromSeq;
       Driver* _driver;
       MasterSynthesizer* _synti;
 
+      LoadMeter _load;                    // time spent in process()
+      unsigned _driverXruns;              // xruns of deleted drivers
+
       double meterValue[2];
       double meterPeakValue[2];
       int peakTimer[2];
@@ -166,7 +172,7 @@ class Seq : public QObject, public Sequencer {
       void seqMessage(int msg, int arg = 0);
       void heartBeatTimeout();
       void midiInputReady();
-      void setPlaylistChanged() { playlistChanged = true; }
+      void setPlaylistChanged();
       void handleTimeSigTempoChanged();
 
    public slots:
@@ -218,6 +224,11 @@ class Seq : public QObject, public Sequencer {
       bool isRealtime() const   { return true;     }
       void sendMessage(SeqMsg&) const;
 
+      LoadMeter& load()         { return _load; }
+      unsigned driverXruns() const;
+      void resetLoad();
+      QString loadReport();
+
       void setController(int, int, int);
       virtual void sendEvent(const NPlayEvent&);
       void setScoreView(ScoreView*);
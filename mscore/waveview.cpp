@@ -15,6 +15,7 @@
 #include "libmscore/audio.h"
 #include "libmscore/score.h"
 
+#include <atomic>
 #include <vorbis/vorbisfile.h>
 
 namespace Ms {
@@ -29,8 +30,6 @@ struct VorbisData {
       QByteArray data;
       };
 
-static VorbisData vorbisData;
-
 static size_t ovRead(void* ptr, size_t size, size_t nmemb, void* datasource);
 static int ovSeek(void* datasource, ogg_int64_t offset, int whence);
 static long ovTell(void* datasource);
@@ -89,6 +88,170 @@ static long ovTell(void* datasource)
       }
 
 
+//---------------------------------------------------------
+//   WavePeaks::append
+//    append level 0 peaks and update the upper levels
+//---------------------------------------------------------
+
+void WavePeaks::append(const QVector<Peak>& p)
+      {
+      if (levels.isEmpty())
+            levels.append(QVector<Peak>());
+      levels[0] += p;
+      for (int level = 1; levels[level - 1].size() > 1; ++level) {
+            if (level == levels.size())
+                  levels.append(QVector<Peak>());
+            const QVector<Peak>& src = levels[level - 1];
+            QVector<Peak>& dst = levels[level];
+            for (int i = dst.size() * 2; i + 1 < src.size(); i += 2)
+                  dst.append({ qMin(src[i].min, src[i+1].min), qMax(src[i].max, src[i+1].max) });
+            }
+      }
+
+//---------------------------------------------------------
+//   WavePeaks::finish
+//    add the odd peaks at the end of every level
+//---------------------------------------------------------
+
+void WavePeaks::finish()
+      {
+      for (int level = 1; level < levels.size(); ++level) {
+            const QVector<Peak>& src = levels[level - 1];
+            if (src.size() & 1)
+                  levels[level].append(src.last());
+            }
+      }
+
+//---------------------------------------------------------
+//   WavePeaks::peak
+//    peak of the frames frame1 - frame2 from the level
+//    where this are at most three entries
+//---------------------------------------------------------
+
+WavePeaks::Peak WavePeaks::peak(int frame1, int frame2) const
+      {
+      Peak p { 0, 0 };
+      if (isEmpty() || frame2 < 0)
+            return p;
+      frame1 = qMax(frame1, 0);
+      int span  = qMax(frame2 - frame1, 1);
+      int level = 0;
+      int bf    = BLOCK;
+      while (level + 1 < levels.size() && bf * 2 <= span) {
+            bf *= 2;
+            ++level;
+            }
+      const QVector<Peak>& l = levels[level];
+      int i1 = frame1 / bf;
+      int i2 = qMin(qMax(frame2 - 1, frame1) / bf, l.size() - 1);
+      if (i1 > i2)
+            return p;
+      p = l[i1];
+      for (int i = i1 + 1; i <= i2; ++i) {
+            p.min = qMin(p.min, l[i].min);
+            p.max = qMax(p.max, l[i].max);
+            }
+      return p;
+      }
+
+//---------------------------------------------------------
+//   WavePeaks::bytes
+//---------------------------------------------------------
+
+int WavePeaks::bytes() const
+      {
+      int n = 0;
+      for (const QVector<Peak>& l : levels)
+            n += l.size() * sizeof(Peak);
+      return n;
+      }
+
+//---------------------------------------------------------
+//   WaveJob
+//    decodes the audio on a worker thread, the peaks are
+//    collected by the view with a timer
+//---------------------------------------------------------
+
+struct WaveJob {
+      VorbisData vd;
+      uint key;
+      std::atomic<bool> abort { false };
+      QMutex mutex;
+      QVector<WavePeaks::Peak> pending;         // guarded by mutex
+      bool done { false };                      // guarded by mutex
+      };
+
+//---------------------------------------------------------
+//   peakCache
+//    peaks of recently shown audio, keyed by data hash
+//---------------------------------------------------------
+
+static QCache<uint, WavePeaks>& peakCache()
+      {
+      static QCache<uint, WavePeaks> cache(64 * 1024 * 1024);
+      return cache;
+      }
+
+static qint8 sample2peak(float v)
+      {
+      return qint8(qBound(-127L, lrintf(v * 127.0f), 127L));
+      }
+
+//---------------------------------------------------------
+//   decodeAudio
+//    worker thread
+//---------------------------------------------------------
+
+static void decodeAudio(QSharedPointer<WaveJob> job)
+      {
+      OggVorbis_File vf;
+      int rv = ov_open_callbacks(&job->vd, &vf, 0, 0, ovCallbacks);
+      if (rv < 0) {
+            qDebug("ogg open failed: %d", rv);
+            QMutexLocker locker(&job->mutex);
+            job->done = true;
+            return;
+            }
+      int channels = ov_info(&vf, -1)->channels;
+      QVector<WavePeaks::Peak> chunk;
+      float mn   = 0.0;
+      float mx   = 0.0;
+      int frames = 0;
+      while (!job->abort) {
+            float** pcm;
+            int section;
+            int n = ov_read_float(&vf, &pcm, 4096, &section);
+            if (n <= 0)
+                  break;
+            for (int i = 0; i < n; ++i) {
+                  float v = pcm[0][i];
+                  if (channels > 1)
+                        v = (v + pcm[1][i]) * 0.5f;
+                  if (frames == 0)
+                        mn = mx = v;
+                  else {
+                        mn = qMin(mn, v);
+                        mx = qMax(mx, v);
+                        }
+                  if (++frames == WavePeaks::BLOCK) {
+                        chunk.append({ sample2peak(mn), sample2peak(mx) });
+                        frames = 0;
+                        }
+                  }
+            if (chunk.size() >= 4096) {
+                  QMutexLocker locker(&job->mutex);
+                  job->pending += chunk;
+                  chunk.clear();
+                  }
+            }
+      if (frames)
+            chunk.append({ sample2peak(mn), sample2peak(mx) });
+      ov_clear(&vf);
+      QMutexLocker locker(&job->mutex);
+      job->pending += chunk;
+      job->done = true;
+      }
+
 //---------------------------------------------------------
 //   WaveView
 //---------------------------------------------------------
@@ -99,80 +262,81 @@ WaveView::WaveView(QWidget* parent)
       _xpos   = 0;
       _xmag   = 0.1;
       _timeType = TType::TICKS;      // TType::FRAMES
+      jobTimer  = new QTimer(this);
+      jobTimer->setInterval(100);
+      connect(jobTimer, SIGNAL(timeout()), SLOT(collectPeaks()));
       setMinimumHeight(50);
       }
 
-static const int WSCALE = 10;
+WaveView::~WaveView()
+      {
+      cancelJob();
+      }
+
+//---------------------------------------------------------
+//   cancelJob
+//---------------------------------------------------------
+
+void WaveView::cancelJob()
+      {
+      if (job) {
+            job->abort = true;      // the worker keeps its own reference
+            job.clear();
+            }
+      jobTimer->stop();
+      }
 
 //---------------------------------------------------------
 //   setAudio
+//    Start decoding the audio in the background. The view
+//    shows the peaks decoded so far.
 //---------------------------------------------------------
 
 void WaveView::setAudio(Audio* audio)
       {
-      waves.clear();
-      OggVorbis_File vf;
-      vorbisData.pos  = 0;
-      vorbisData.data = audio->data();
-      int rv = ov_open_callbacks(&vorbisData, &vf, 0, 0, ovCallbacks);
-      if (rv < 0) {
-            qDebug("ogg open failed: %d", rv);
+      cancelJob();
+      peaks = WavePeaks();
+      if (!audio || audio->data().isEmpty())
+            return;
+      uint key = qHash(audio->data());
+      if (WavePeaks* wp = peakCache().object(key)) {
+            peaks = *wp;
+            update();
             return;
             }
-      int rn = 0;
-      const int n = 10000 / WSCALE;
-      uchar dst[n];
-      float* r = 0;
-      float* l = 0;
-      for (;;) {
-            for (int i = 0; i < n; ++i) {
-                  float val = 0;
-                  for (int k = 0; k < WSCALE; ++k) {
-                        if (rn == 0) {
-                              float** pcm;
-                              int section;
-                              rn = ov_read_float(&vf, &pcm, 1000, &section);
-                              if (rn == 0) {
-                                    for (; i < n; ++i)
-                                          dst[i] = 0;
-                                    waves.append((char*)dst, n);
-                                    ov_clear(&vf);
-                                    return;
-                                    }
-                              r = pcm[0];
-                              l = pcm[1];
-                              }
-                        val += fabsf(*r++) + fabsf(*l++);
-                        --rn;
-                        }
-                  unsigned int v = lrint(val * 128);
-                  if (v > 255)
-                        v = 255;
-                  dst[i] = v;
-                  }
-            waves.append((char*)dst, n);
-            }
+      job = QSharedPointer<WaveJob>(new WaveJob);
+      job->vd.pos  = 0;
+      job->vd.data = audio->data();
+      job->key     = key;
+      QtConcurrent::run(decodeAudio, job);
+      jobTimer->start();
       }
 
 //---------------------------------------------------------
-//   pegel
+//   collectPeaks
+//    take the peaks decoded so far from the worker
 //---------------------------------------------------------
 
-int WaveView::pegel(int frame1, int frame2)
+void WaveView::collectPeaks()
       {
-      if (frame1 < 0)
-            frame1 = 0;
-      if (frame1 > frame2)
-            return 0;
-      frame1 = (frame1 + WSCALE/2) / WSCALE;
-      frame2 = (frame2 + WSCALE/2) / WSCALE;
-      if (frame2 >= waves.size())
-            frame2 = waves.size()-1;
-      int p = 0;
-      for (int i = frame1; i <= frame2; ++i)
-            p += uchar(waves[i]);
-      p /= (frame2 - frame1 + 1);
-      return p;
+      if (!job)
+            return;
+      QVector<WavePeaks::Peak> p;
+      job->mutex.lock();
+      p.swap(job->pending);
+      bool done = job->done;
+      job->mutex.unlock();
+      if (!p.isEmpty()) {
+            peaks.append(p);
+            update();
+            }
+      if (done) {
+            peaks.finish();
+            peakCache().insert(job->key, new WavePeaks(peaks), peaks.bytes());
+            job.clear();
+            jobTimer->stop();
+            update();
+            }
       }
 
 //---------------------------------------------------------
@@ -266,12 +430,13 @@ void WaveView::paintEvent(QPaintEvent* event)
             x1 = pianoWidth;
       Pos p1 = pix2pos(x1);
       p.setPen(QPen(Qt::blue, 1));
+      int h = height() / 2;
       for (int i = x1+1; i < x2; ++i) {
             Pos p2 = pix2pos(i);
-            int val = height() * pegel(p1.frame(), p2.frame()) / 255;
+            WavePeaks::Peak pk = peaks.peak(p1.frame(), p2.frame());
             p1 = p2;
-            int y1 = height() - val;
-            int y2 = height();
+            int y1 = h - h * pk.max / 127;
+            int y2 = h - h * pk.min / 127;
             p.drawLine(i, y1, i, y2);
             }
 
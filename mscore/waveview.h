@@ -19,6 +19,33 @@ namespace Ms {
 
 class Audio;
 class Score;
+struct WaveJob;
+
+//---------------------------------------------------------
+//   WavePeaks
+//    min/max pyramid of a mono mix of the audio. Level 0
+//    holds one peak per BLOCK frames, every further level
+//    combines two peaks of the level below.
+//---------------------------------------------------------
+
+class WavePeaks {
+   public:
+      struct Peak {
+            qint8 min;
+            qint8 max;
+            };
+      static const int BLOCK = 64;
+
+   private:
+      QList<QVector<Peak>> levels;
+
+   public:
+      void append(const QVector<Peak>&);
+      void finish();
+      Peak peak(int frame1, int frame2) const;
+      bool isEmpty() const    { return levels.isEmpty() || levels[0].isEmpty(); }
+      int bytes() const;
+      };
 
 //---------------------------------------------------------
 //   WaveView
@@ -30,7 +57,9 @@ class WaveView : public QWidget
       Pos _cursor;
       Pos* _locator;
       Score* _score;
-      QByteArray waves;
+      WavePeaks peaks;
+      QSharedPointer<WaveJob> job;
+      QTimer* jobTimer;
 
       TType _timeType;
       int magStep;
@@ -41,7 +70,10 @@ class WaveView : public QWidget
       Pos pix2pos(int x) const;
       virtual void paintEvent(QPaintEvent*);
       virtual QSize sizeHint() const { return QSize(50, 50); }
-      int pegel(int frame1, int frame2);
+      void cancelJob();
+
+   private slots:
+      void collectPeaks();
 
    public slots:
       void setMag(double,double);
@@ -49,6 +81,7 @@ class WaveView : public QWidget
 
    public:
       WaveView(QWidget* parent = 0);
+      ~WaveView();
       void setAudio(Audio*);
       void setXpos(int);
       void setScore(Score* s, Pos* lc);
@@ -0,0 +1,147 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2015 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+#include "libmscore/sym.h"
+#include "libmscore/glyphcache.h"
+
+using namespace Ms;
+
+//---------------------------------------------------------
+//   TestGlyphCache
+//---------------------------------------------------------
+
+class TestGlyphCache : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      ScoreFont* font;
+      GlyphCache* cache;
+
+      QImage render(SymId, qreal scale, const QColor&);
+
+   private slots:
+      void initTestCase();
+      void init();
+      void hits();
+      void colors();
+      void budget();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestGlyphCache::initTestCase()
+      {
+      initMTest();
+      font  = ScoreFont::fontFactory("Emmentaler");
+      cache = GlyphCache::instance();
+      }
+
+//---------------------------------------------------------
+//   init
+//---------------------------------------------------------
+
+void TestGlyphCache::init()
+      {
+      cache->clear();
+      cache->resetStats();
+      }
+
+//---------------------------------------------------------
+//   render
+//    draw a symbol into an image
+//---------------------------------------------------------
+
+QImage TestGlyphCache::render(SymId id, qreal scale, const QColor& color)
+      {
+      QImage image(200, 200, QImage::Format_ARGB32_Premultiplied);
+      image.fill(0);
+      QPainter p(&image);
+      p.scale(scale, scale);
+      p.setPen(color);
+      font->draw(id, &p, 1.0, QPointF(50.0, 100.0) / scale);
+      return image;
+      }
+
+//---------------------------------------------------------
+//   hits
+//    a glyph is rendered once per size
+//---------------------------------------------------------
+
+void TestGlyphCache::hits()
+      {
+      QImage a = render(SymId::gClef, 1.0, Qt::black);
+      QImage b = render(SymId::gClef, 1.0, Qt::black);
+      QCOMPARE(a, b);
+      QCOMPARE(cache->stats().misses, quint64(1));
+      QCOMPARE(cache->stats().hits, quint64(1));
+
+      render(SymId::gClef, 2.0, Qt::black);
+      QCOMPARE(cache->stats().misses, quint64(2));
+      QCOMPARE(cache->stats().glyphs, 2);
+      }
+
+//---------------------------------------------------------
+//   colors
+//    all colors are tinted from the same mask
+//---------------------------------------------------------
+
+void TestGlyphCache::colors()
+      {
+      QImage black = render(SymId::noteheadBlack, 1.5, Qt::black);
+      QImage red   = render(SymId::noteheadBlack, 1.5, Qt::red);
+      QCOMPARE(cache->stats().misses, quint64(1));
+      bool inked = false;
+      for (int y = 0; y < black.height(); ++y) {
+            for (int x = 0; x < black.width(); ++x) {
+                  QRgb b = black.pixel(x, y);
+                  QRgb r = red.pixel(x, y);
+                  QCOMPARE(qAlpha(r), qAlpha(b));
+                  QCOMPARE(qGreen(r), 0);
+                  if (qAlpha(b) == 255) {
+                        QCOMPARE(qRed(r), 255);
+                        inked = true;
+                        }
+                  }
+            }
+      QVERIFY(inked);
+      }
+
+//---------------------------------------------------------
+//   budget
+//    old pages are dropped when the budget is exceeded
+//---------------------------------------------------------
+
+void TestGlyphCache::budget()
+      {
+      qint64 budget = cache->budget();
+      cache->setBudget(1024 * 1024);
+      for (int i = 0; i < 20; ++i)
+            render(SymId::gClef, 1.0 + i * 0.1, Qt::black);
+      GlyphCache::Stats s = cache->stats();
+      QVERIFY(s.evictions > 0);
+      QVERIFY(s.pages < 20);
+      QVERIFY(s.bytes <= 2 * 1024 * 1024);
+
+      // evicted glyphs are rendered again
+      quint64 misses = s.misses;
+      render(SymId::gClef, 1.0, Qt::black);
+      QCOMPARE(cache->stats().misses, misses + 1);
+      cache->setBudget(budget);
+      }
+
+QTEST_MAIN(TestGlyphCache)
+#include "tst_glyphcache.moc"
+
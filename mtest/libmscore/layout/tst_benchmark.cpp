@@ -15,7 +15,7 @@
 #include "mtest/testutils.h"
 #include "libmscore/score.h"
 
-#define DIR QString("libmscore/layout/")
+#define GOLDBERG QString("../demos/goldberg.mscz")
 
 using namespace Ms;
 
@@ -31,7 +31,7 @@ class TestBenchmark : public QObject, public MTest
       {
       Q_OBJECT
 
-      Score* score;
+      Score* score { 0 };
       void beam(const char* path);
 
    private slots:
@@ -39,6 +39,8 @@ class TestBenchmark : public QObject, public MTest
       void benchmark3();
       void benchmark1();
       void benchmark2();
+      void benchmark4();
+      void benchmark5();
       };
 
 //---------------------------------------------------------
@@ -56,19 +58,20 @@ void TestBenchmark::initTestCase()
 
 void TestBenchmark::benchmark3()
       {
-      QString path = root + "/" + DIR + "goldberg.mscx";
+      QString path = root + "/" + GOLDBERG;
       score = new Score(mscore->baseStyle());
       score->setName(path);
       MScore::testMode = true;
       QBENCHMARK {
-            score->loadMsc(path, false);
+            QVERIFY(score->loadMsc(path, false) == Score::FileError::FILE_NO_ERROR);
             }
 //      Ms::dumpTags();
       }
 
 void TestBenchmark::benchmark1()
       {
-      score = readScore(DIR + "goldberg.mscx");
+      score = readScore(GOLDBERG);
+      QVERIFY(score);
       QBENCHMARK {                        // cold run
             score->doLayout();
             }
@@ -76,12 +79,33 @@ void TestBenchmark::benchmark1()
 
 void TestBenchmark::benchmark2()
       {
+      QVERIFY(score);
       score->doLayout();
       QBENCHMARK {                        // warm run
             score->doLayout();
             }
       }
 
+void TestBenchmark::benchmark4()
+      {
+      QBENCHMARK {                        // load, layout and close
+            Score* s = readScore(GOLDBERG);
+            QVERIFY(s);
+            s->doLayout();
+            delete s;
+            }
+      }
+
+void TestBenchmark::benchmark5()
+      {
+      Score* s = readScore(GOLDBERG);
+      QVERIFY(s);
+      s->doLayout();
+      QBENCHMARK_ONCE {                   // close
+            delete s;
+            }
+      }
+
 QTEST_MAIN(TestBenchmark)
 #include "tst_benchmark.moc"
 
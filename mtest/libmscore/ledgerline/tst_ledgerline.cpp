@@ -0,0 +1,98 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2015 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+#include "libmscore/score.h"
+#include "libmscore/measure.h"
+#include "libmscore/segment.h"
+#include "libmscore/chord.h"
+#include "libmscore/ledgerline.h"
+
+#define DIR QString("libmscore/beam/")
+
+using namespace Ms;
+
+//---------------------------------------------------------
+//   TestLedgerLine
+//---------------------------------------------------------
+
+class TestLedgerLine : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      QStringList ledgerLines(Score* score);
+
+   private slots:
+      void initTestCase();
+      void relayout();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestLedgerLine::initTestCase()
+      {
+      initMTest();
+      }
+
+//---------------------------------------------------------
+//   ledgerLines
+//    tick, track and geometry of all ledger lines
+//---------------------------------------------------------
+
+QStringList TestLedgerLine::ledgerLines(Score* score)
+      {
+      QStringList l;
+      for (Segment* s = score->firstSegment(Segment::Type::ChordRest); s; s = s->next1(Segment::Type::ChordRest)) {
+            for (int track = 0; track < score->ntracks(); ++track) {
+                  Element* e = s->element(track);
+                  if (!e || e->type() != Element::Type::CHORD)
+                        continue;
+                  for (LedgerLine* ll = static_cast<Chord*>(e)->ledgerLines(); ll; ll = ll->next()) {
+                        QRectF r = ll->bbox().translated(ll->pos());
+                        l.append(QString("%1 %2 %3 %4 %5 %6").arg(s->tick()).arg(track)
+                           .arg(r.x()).arg(r.y()).arg(r.width()).arg(r.height()));
+                        }
+                  }
+            }
+      return l;
+      }
+
+//---------------------------------------------------------
+//   relayout
+//    a relayout takes the ledger lines of the last layout
+//    from the score's pool and places them the same way
+//---------------------------------------------------------
+
+void TestLedgerLine::relayout()
+      {
+      Score* score = readScore(DIR + "Beam-A.mscx");
+      QVERIFY(score);
+      score->doLayout();
+      QStringList lines = ledgerLines(score);
+      QVERIFY(!lines.isEmpty());
+
+      ElementPool<LedgerLine>& pool = score->ledgerLinePool();
+      int created = pool.created();
+      QCOMPARE(created, lines.size() + pool.size());
+
+      score->doLayout();
+      QCOMPARE(pool.created(), created);
+      QVERIFY(pool.reused() >= created);
+      QCOMPARE(ledgerLines(score), lines);
+      delete score;
+      }
+
+QTEST_MAIN(TestLedgerLine)
+#include "tst_ledgerline.moc"
@@ -23,6 +23,8 @@
 #include "libmscore/chord.h"
 #include "libmscore/note.h"
 #include "libmscore/keysig.h"
+#include "libmscore/pitchspelling.h"
+#include "libmscore/undo.h"
 #include "mscore/exportmidi.h"
 #include "mscore/preferences.h"
 #include <QIODevice>
@@ -44,7 +46,12 @@ using namespace Ms;
 class TestMidi : public QObject, public MTest
       {
       Q_OBJECT
+      int changedStartTick;
+      int changedEndTick;
+
       void midiExportTestRef(const QString& file);
+      void collectChangedRange(Score*);
+      void checkRenderMidiRange(Score*, EventMap*, bool incremental);
 
    private slots:
       void initTestCase();
@@ -56,6 +63,7 @@ class TestMidi : public QObject, public MTest
       void midiBendsExport1() { midiExportTestRef("testBends1"); }
       void midiBendsExport2() { midiExportTestRef("testBends2"); }      // Play property test
       void midiPortExport()   { midiExportTestRef("testMidiPort"); }
+      void renderMidiRange();
       };
 
 //---------------------------------------------------------
@@ -382,6 +390,160 @@ void TestMidi::events()
      // QVERIFY(saveCompareScore(score, writeFile, reference));
       }
 
+//---------------------------------------------------------
+//   eventList
+//    the events of an event map in a fixed order; the order
+//    of events at the same tick does not matter
+//---------------------------------------------------------
+
+static QStringList eventList(const EventMap& events)
+      {
+      QStringList l;
+      for (const auto& e : events) {
+            const NPlayEvent& ev = e.second;
+            l.append(QString("%1 %2 %3 %4 %5").arg(e.first, 8).arg(ev.type())
+               .arg(ev.channel()).arg(ev.dataA()).arg(ev.dataB()));
+            }
+      l.sort();
+      return l;
+      }
+
+//---------------------------------------------------------
+//   chordAt
+//    chord idx of track 0 in measure m
+//---------------------------------------------------------
+
+static Chord* chordAt(Measure* m, int idx)
+      {
+      const Segment::Type st = Segment::Type::ChordRest;
+      for (Segment* s = m->first(st); s; s = s->next(st)) {
+            if (idx-- == 0) {
+                  Element* e = s->element(0);
+                  return e && e->type() == Element::Type::CHORD ? static_cast<Chord*>(e) : 0;
+                  }
+            }
+      return 0;
+      }
+
+//---------------------------------------------------------
+//   collectChangedRange
+//    collect the changed range of the playlist like
+//    Seq::setPlaylistChanged() does
+//---------------------------------------------------------
+
+void TestMidi::collectChangedRange(Score* score)
+      {
+      int stick;
+      int etick;
+      score->playlistRange(&stick, &etick);
+      if (stick == -1)
+            changedStartTick = -1;
+      else if (stick != INT_MAX) {
+            changedStartTick = qMin(changedStartTick, stick);
+            changedEndTick   = qMax(changedEndTick, etick);
+            }
+      }
+
+//---------------------------------------------------------
+//   checkRenderMidiRange
+//    update events like Seq::collectEvents() does and
+//    compare them with a full render of the score
+//---------------------------------------------------------
+
+void TestMidi::checkRenderMidiRange(Score* score, EventMap* events, bool incremental)
+      {
+      bool rendered = changedStartTick != -1
+         && score->renderMidiRange(events, changedStartTick, changedEndTick);
+      if (incremental)
+            QVERIFY(rendered);
+      if (!rendered) {
+            events->clear();
+            score->renderMidi(events);
+            }
+      changedStartTick = INT_MAX;
+      changedEndTick   = -1;
+
+      EventMap full;
+      score->renderMidi(&full);
+      QCOMPARE(eventList(*events), eventList(full));
+      }
+
+//---------------------------------------------------------
+//   renderMidiRange
+//    local edits in a score with repeats and ties; the
+//    incrementally updated events must match a full render
+//    after every edit
+//---------------------------------------------------------
+
+void TestMidi::renderMidiRange()
+      {
+      Score* score = readScore(DIR + "testRepeatsTies.mscx");
+      QVERIFY(score);
+      score->doLayout();
+      connect(score, &Score::playlistChanged, [this, score] { collectChangedRange(score); });
+
+      // the first command after loading renders everything
+      changedStartTick = INT_MAX;
+      changedEndTick   = -1;
+      score->startCmd();
+      score->endCmd();
+      EventMap events;
+      checkRenderMidiRange(score, &events, false);
+
+      Measure* m1 = score->firstMeasure();
+      Measure* m2 = m1->nextMeasure();      // start repeat, tied from m1
+      Measure* m3 = m2->nextMeasure();      // end repeat
+
+      // change a pitch inside of the repeat
+      Note* note = chordAt(m2, 1)->upNote();
+      int pitch  = note->pitch() + 2;
+      int tpc    = pitch2tpc(pitch, Key::C, Prefer::NEAREST);
+      score->startCmd();
+      score->undoChangePitch(note, pitch, tpc, tpc);
+      score->endCmd();
+      checkRenderMidiRange(score, &events, true);
+
+      // add a note to a chord and remove it again
+      Chord* chord = chordAt(m3, 0);
+      NoteVal nval(79);
+      nval.tpc1 = pitch2tpc(79, Key::C, Prefer::NEAREST);
+      nval.tpc2 = nval.tpc1;
+      score->startCmd();
+      note = score->addNote(chord, nval);
+      score->endCmd();
+      QVERIFY(note);
+      checkRenderMidiRange(score, &events, true);
+
+      score->startCmd();
+      score->undoRemoveElement(note);
+      score->endCmd();
+      checkRenderMidiRange(score, &events, true);
+
+      // remove a chord, then add it again by undo
+      score->startCmd();
+      score->select(chordAt(m3, 1));
+      score->cmdDeleteSelection();
+      score->endCmd();
+      checkRenderMidiRange(score, &events, false);
+
+      score->undo()->undo();
+      score->endUndoRedo();
+      checkRenderMidiRange(score, &events, false);
+
+      // edit the end of a tie across the start repeat; the whole
+      // tie chain has to be rendered again
+      note = chordAt(m2, 0)->upNote();
+      QVERIFY(note->tieBack());
+      pitch = note->pitch() - 1;
+      tpc   = pitch2tpc(pitch, Key::C, Prefer::NEAREST);
+      score->startCmd();
+      score->undoChangePitch(note, pitch, tpc, tpc);
+      score->endCmd();
+      checkRenderMidiRange(score, &events, true);
+
+      delete score;
+      }
+
 //---------------------------------------------------------
 //   midiExportTest
 //   read a MuseScore mscx file, write to a MIDI file and verify against reference
@@ -0,0 +1,126 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2015 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+#include "libmscore/score.h"
+#include "libmscore/page.h"
+#include "libmscore/sym.h"
+
+#define DIR QString("libmscore/midi/")
+
+using namespace Ms;
+
+//---------------------------------------------------------
+//   TestPrintPages
+//    pages painted on the thread pool, as done by the
+//    PDF, SVG and PNG export, must give the same output
+//    as pages painted one after the other
+//---------------------------------------------------------
+
+class TestPrintPages : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      void comparePages(bool pdf);
+
+   private slots:
+      void initTestCase();
+      void pdf()  { comparePages(true);  }
+      void png()  { comparePages(false); }
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestPrintPages::initTestCase()
+      {
+      initMTest();
+      }
+
+//---------------------------------------------------------
+//   recordPage
+//    like recordPage() in mscore/file.cpp
+//---------------------------------------------------------
+
+static QPicture recordPage(Page* page)
+      {
+      QList<const Element*> el = page->elements();
+      qStableSort(el.begin(), el.end(), elementLessThan);
+      QPicture picture;
+      QPainter p(&picture);
+      for (const Element* e : el) {
+            if (!e->visible())
+                  continue;
+            QPointF pos(e->pagePos());
+            p.translate(pos);
+            e->draw(&p);
+            p.translate(-pos);
+            }
+      p.end();
+      return picture;
+      }
+
+//---------------------------------------------------------
+//   playBack
+//---------------------------------------------------------
+
+static QImage playBack(const QPicture& picture, const QSizeF& size)
+      {
+      QImage image(size.toSize(), QImage::Format_ARGB32_Premultiplied);
+      image.fill(Qt::white);
+      QPainter p(&image);
+      p.setRenderHint(QPainter::Antialiasing, true);
+      p.setRenderHint(QPainter::TextAntialiasing, true);
+      p.drawPicture(0, 0, picture);
+      p.end();
+      return image;
+      }
+
+//---------------------------------------------------------
+//   comparePages
+//    record every page serially and concurrently; the
+//    recorded paint commands and the played back pages
+//    must be the same
+//---------------------------------------------------------
+
+void TestPrintPages::comparePages(bool pdf)
+      {
+      Score* score = readScore(DIR + "testAndanteExcerpts.mscx");
+      QVERIFY(score);
+      score->doLayout();
+      QList<Page*> pl = score->pages();
+      QVERIFY(pl.size() > 1);
+
+      score->setPrinting(true);
+      MScore::pdfPrinting = pdf;
+      QList<QPicture> serial;
+      for (Page* page : pl)
+            serial.append(recordPage(page));
+      QList<QPicture> parallel = QtConcurrent::blockingMapped(pl, recordPage);
+      MScore::pdfPrinting = false;
+      score->setPrinting(false);
+
+      QCOMPARE(parallel.size(), serial.size());
+      for (int i = 0; i < pl.size(); ++i) {
+            QCOMPARE(parallel[i].size(), serial[i].size());
+            QVERIFY2(parallel[i].data() && !memcmp(parallel[i].data(), serial[i].data(), serial[i].size()),
+               qPrintable(QString("page %1 differs").arg(i + 1)));
+            QSizeF size(pl[i]->bbox().size());
+            QVERIFY(playBack(parallel[i], size) == playBack(serial[i], size));
+            }
+      delete score;
+      }
+
+QTEST_MAIN(TestPrintPages)
+#include "tst_printpages.moc"
@@ -0,0 +1,171 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2015 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+#include "libmscore/score.h"
+#include "libmscore/measure.h"
+#include "libmscore/segment.h"
+#include "libmscore/chord.h"
+#include "libmscore/note.h"
+#include "libmscore/undo.h"
+
+#define DIR QString("libmscore/midi/")
+
+using namespace Ms;
+
+//---------------------------------------------------------
+//   TestRelayout
+//---------------------------------------------------------
+
+class TestRelayout : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      Note* findNote(Score*, int measureIdx);
+      void compareLayout(Score*);
+
+   private slots:
+      void initTestCase();
+      void relayoutPitch();
+      void relayoutUndo();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestRelayout::initTestCase()
+      {
+      initMTest();
+      }
+
+//---------------------------------------------------------
+//   collectRect
+//---------------------------------------------------------
+
+static void collectRect(void* data, Element* e)
+      {
+      QList<QRectF>* rl = static_cast<QList<QRectF>*>(data);
+      rl->append(e->pageBoundingRect());
+      }
+
+//---------------------------------------------------------
+//   findNote
+//    return the top note of the first chord in track 0
+//    of measure measureIdx
+//---------------------------------------------------------
+
+Note* TestRelayout::findNote(Score* score, int measureIdx)
+      {
+      Measure* m = score->firstMeasure();
+      for (int i = 0; i < measureIdx && m; ++i)
+            m = m->nextMeasure();
+      if (!m)
+            return 0;
+      for (Segment* s = m->first(Segment::Type::ChordRest); s; s = s->next(Segment::Type::ChordRest)) {
+            Element* e = s->element(0);
+            if (e && e->type() == Element::Type::CHORD)
+                  return static_cast<Chord*>(e)->upNote();
+            }
+      return 0;
+      }
+
+//---------------------------------------------------------
+//   compareLayout
+//    the current (incremental) layout must be identical
+//    to a full layout of the score
+//---------------------------------------------------------
+
+void TestRelayout::compareLayout(Score* score)
+      {
+      QList<QRectF> incremental;
+      score->scanElements(&incremental, collectRect);
+
+      score->doLayout();
+      QList<QRectF> full;
+      score->scanElements(&full, collectRect);
+
+      QCOMPARE(incremental.size(), full.size());
+      for (int i = 0; i < full.size(); ++i)
+            QCOMPARE(incremental[i], full[i]);
+      }
+
+//---------------------------------------------------------
+//   relayoutPitch
+//    change the pitch of a note; the command must be local
+//    and the incremental layout must match a full layout
+//---------------------------------------------------------
+
+void TestRelayout::relayoutPitch()
+      {
+      Score* score = readScore(DIR + "testAndanteExcerpts.mscx");
+      score->doLayout();
+
+      Note* note = findNote(score, 5);
+      QVERIFY(note);
+      Measure* m = note->chord()->measure();
+      int pitch  = note->pitch();
+
+      score->startCmd();
+      score->undoChangePitch(note, pitch + 12, note->tpc1(), note->tpc2());
+      int stick = -1;
+      int etick = -1;
+      QVERIFY(score->undo()->current()->tickRange(&stick, &etick));
+      QCOMPARE(stick, m->tick());         // relayout is limited to the measure of the note
+      QCOMPARE(etick, m->endTick());
+      score->endCmd();
+      QCOMPARE(note->pitch(), pitch + 12);
+
+      compareLayout(score);
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   relayoutUndo
+//    incremental layout after several local edits,
+//    then full layout after undo
+//---------------------------------------------------------
+
+void TestRelayout::relayoutUndo()
+      {
+      Score* score = readScore(DIR + "testAndanteExcerpts.mscx");
+      score->doLayout();
+
+      Note* last = 0;
+      int pitch  = 0;
+      for (int i = 1; i < 20; i += 6) {
+            Note* note = findNote(score, i);
+            QVERIFY(note);
+            Measure* m = note->chord()->measure();
+            last  = note;
+            pitch = note->pitch();
+            score->startCmd();
+            score->undoChangePitch(note, pitch - 12, note->tpc1(), note->tpc2());
+            int stick = -1;
+            int etick = -1;
+            QVERIFY(score->undo()->current()->tickRange(&stick, &etick));
+            QCOMPARE(stick, m->tick());
+            QCOMPARE(etick, m->endTick());
+            score->endCmd();
+            compareLayout(score);
+            }
+
+      score->undo()->undo();
+      score->endUndoRedo();
+      QCOMPARE(last->pitch(), pitch);
+      compareLayout(score);
+      delete score;
+      }
+
+QTEST_MAIN(TestRelayout)
+#include "tst_relayout.moc"
@@ -0,0 +1,213 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2015 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+#include "libmscore/score.h"
+#include "libmscore/tempo.h"
+#include "libmscore/repeatlist.h"
+
+using namespace Ms;
+
+static const int SEGMENTS = 400;       // repeat segments
+static const int TEMPI    = 500;       // tempo changes
+static const int MEASURE  = 4 * 480;
+
+//---------------------------------------------------------
+//   TestTempoMap
+//    conversion between tick, utick and time on a
+//    synthetic score with many repeats and tempo changes
+//---------------------------------------------------------
+
+class TestTempoMap : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      Score* score;
+      RepeatList* rl;
+      int endTick;
+
+      int refTick2utick(int tick) const;
+      int refTime2tick(qreal time) const;
+
+   private slots:
+      void initTestCase();
+      void cleanupTestCase();
+      void time2tick();
+      void tick2utick();
+      void utick2utime();
+      void benchmarkTick2utick();
+      void benchmarkUtick2utime();
+      void benchmarkUtime2utick();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//    every segment plays two measures and jumps back one
+//    measure, tempo changes every 1.5 measures with some
+//    pauses
+//---------------------------------------------------------
+
+void TestTempoMap::initTestCase()
+      {
+      initMTest();
+      score = new Score(mscore->baseStyle());
+      TempoMap* tm = score->tempomap();
+      for (int i = 0; i < TEMPI; ++i) {
+            int tick = i * MEASURE * 3 / 2;
+            tm->setTempo(tick, 1.0 + (i % 7) * 0.25);
+            if (i % 5 == 2)
+                  tm->setPause(tick, 0.5);
+            }
+      rl = new RepeatList(score);
+      for (int i = 0; i < SEGMENTS; ++i) {
+            RepeatSegment* s = new RepeatSegment;
+            s->tick = i * MEASURE;
+            s->len  = 2 * MEASURE;
+            rl->append(s);
+            }
+      endTick = (SEGMENTS + 1) * MEASURE;
+      rl->update();
+      }
+
+//---------------------------------------------------------
+//   cleanupTestCase
+//---------------------------------------------------------
+
+void TestTempoMap::cleanupTestCase()
+      {
+      qDeleteAll(*rl);
+      delete rl;
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   refTick2utick
+//    linear reference implementation
+//---------------------------------------------------------
+
+int TestTempoMap::refTick2utick(int tick) const
+      {
+      for (const RepeatSegment* s : *rl) {
+            if (tick >= s->tick && tick < (s->tick + s->len))
+                  return s->utick + (tick - s->tick);
+            }
+      return rl->last()->utick + (tick - rl->last()->tick);
+      }
+
+//---------------------------------------------------------
+//   refTime2tick
+//    linear reference implementation
+//---------------------------------------------------------
+
+int TestTempoMap::refTime2tick(qreal time) const
+      {
+      const TempoMap* tm = score->tempomap();
+      int tick    = 0;
+      qreal delta = 0.0;
+      qreal tempo = 2.0;
+      for (auto e = tm->begin(); e != tm->end(); ++e) {
+            if ((time <= e->second.time) && (time > e->second.time - e->second.pause)) {
+                  delta = (time - (e->second.time - e->second.pause) + delta);
+                  break;
+                  }
+            if (e->second.time >= time)
+                  break;
+            delta = e->second.time;
+            tick  = e->first;
+            tempo = e->second.tempo;
+            }
+      delta = time - delta;
+      return tick + lrint(delta * tm->relTempo() * MScore::division * tempo);
+      }
+
+//---------------------------------------------------------
+//   time2tick
+//---------------------------------------------------------
+
+void TestTempoMap::time2tick()
+      {
+      const TempoMap* tm = score->tempomap();
+      qreal end = tm->tick2time(endTick);
+      for (qreal t = 0.0; t < end; t += 0.0731)
+            QCOMPARE(tm->time2tick(t), refTime2tick(t));
+      for (auto e = tm->begin(); e != tm->end(); ++e) {
+            QCOMPARE(tm->time2tick(e->second.time), refTime2tick(e->second.time));
+            QCOMPARE(tm->time2tick(e->second.time - e->second.pause * .5), refTime2tick(e->second.time - e->second.pause * .5));
+            }
+      }
+
+//---------------------------------------------------------
+//   tick2utick
+//---------------------------------------------------------
+
+void TestTempoMap::tick2utick()
+      {
+      for (int tick = 0; tick < endTick + MEASURE; tick += 37)
+            QCOMPARE(rl->tick2utick(tick), refTick2utick(tick));
+      }
+
+//---------------------------------------------------------
+//   utick2utime
+//    forward, backward and random access must give the
+//    same results
+//---------------------------------------------------------
+
+void TestTempoMap::utick2utime()
+      {
+      int uticks = rl->ticks();
+      QList<qreal> times;
+      for (int utick = 0; utick < uticks; utick += 53)
+            times.append(rl->utick2utime(utick));
+      int n = times.size();
+      for (int i = n - 1; i >= 0; --i)
+            QCOMPARE(rl->utick2utime(i * 53), times[i]);
+      for (int i = 0; i < n; ++i) {
+            int k = (i * 7919) % n;
+            QCOMPARE(rl->utick2utime(k * 53), times[k]);
+            }
+      }
+
+//---------------------------------------------------------
+//   benchmarks
+//    monotonic access, as in Seq::process() and the
+//    audio export loop
+//---------------------------------------------------------
+
+void TestTempoMap::benchmarkTick2utick()
+      {
+      QBENCHMARK {
+            for (int tick = 0; tick < endTick; tick += 60)
+                  rl->tick2utick(tick);
+            }
+      }
+
+void TestTempoMap::benchmarkUtick2utime()
+      {
+      int uticks = rl->ticks();
+      QBENCHMARK {
+            for (int utick = 0; utick < uticks; utick += 60)
+                  rl->utick2utime(utick);
+            }
+      }
+
+void TestTempoMap::benchmarkUtime2utick()
+      {
+      qreal end = rl->utick2utime(rl->ticks());
+      QBENCHMARK {
+            for (qreal t = 0.0; t < end; t += 0.01)
+                  rl->utime2utick(t);
+            }
+      }
+
+QTEST_MAIN(TestTempoMap)
+#include "tst_tempomap.moc"
@@ -0,0 +1,184 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2015 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+#include "libmscore/score.h"
+#include "libmscore/page.h"
+#include "libmscore/system.h"
+#include "libmscore/measure.h"
+#include "libmscore/spanner.h"
+#include "libmscore/undo.h"
+
+#define DIR      QString("libmscore/thumbnail/")
+#define MIDI_DIR QString("libmscore/midi/")
+
+using namespace Ms;
+
+//---------------------------------------------------------
+//   TestThumbnail
+//---------------------------------------------------------
+
+class TestThumbnail : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      Score* score;
+
+   private slots:
+      void initTestCase();
+      void cleanupTestCase();
+      void firstPageEnd();
+      void lineMode();
+      void lineModeSpanners();
+      void benchmarkLineMode();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//    a score of several pages
+//---------------------------------------------------------
+
+void TestThumbnail::initTestCase()
+      {
+      initMTest();
+      score = readScore(MIDI_DIR + "testAndanteExcerpts.mscx");
+      QVERIFY(score);
+      score->startCmd();
+      score->appendMeasures(300);
+      score->endCmd();
+      }
+
+//---------------------------------------------------------
+//   cleanupTestCase
+//---------------------------------------------------------
+
+void TestThumbnail::cleanupTestCase()
+      {
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   firstPageEnd
+//    the estimate taken in line mode must cover all
+//    measures of the first page in page mode
+//---------------------------------------------------------
+
+void TestThumbnail::firstPageEnd()
+      {
+      score->setLayoutMode(LayoutMode::LINE);
+      score->doLayout();
+      MeasureBase* end = score->firstPageEnd();
+      QVERIFY(end);
+
+      score->setLayoutMode(LayoutMode::PAGE);
+      score->doLayout();
+      QVERIFY(score->npages() > 1);
+      Page* page = score->pages().front();
+      MeasureBase* last = page->systems()->back()->measures().back();
+      QVERIFY(last->tick() < end->tick());
+      }
+
+//---------------------------------------------------------
+//   isBlank
+//---------------------------------------------------------
+
+static bool isBlank(const QImage& image)
+      {
+      for (int y = 0; y < image.height(); ++y) {
+            for (int x = 0; x < image.width(); ++x) {
+                  if (image.pixel(x, y) != 0xffffffff)
+                        return false;
+                  }
+            }
+      return true;
+      }
+
+//---------------------------------------------------------
+//   lineMode
+//    a thumbnail in line mode must be the one of page
+//    mode and must not change the layout mode or the
+//    undo stack
+//---------------------------------------------------------
+
+void TestThumbnail::lineMode()
+      {
+      score->setLayoutMode(LayoutMode::PAGE);
+      score->doLayout();
+      QImage pageImage = score->createThumbnail();
+
+      score->setLayoutMode(LayoutMode::LINE);
+      score->doLayout();
+      bool canRedo = score->undo()->canRedo();
+      bool clean   = score->undo()->isClean();
+      int systems = score->systems()->size();
+
+      QImage pm = score->createThumbnail();
+      QVERIFY(!pm.isNull());
+      int size = qMax(pm.width(), pm.height());   // the longer side is scaled to 256
+      QVERIFY(size >= 255 && size <= 256);
+      QVERIFY(pm.height() > pm.width());          // portrait page
+      QVERIFY(!isBlank(pm));
+      QCOMPARE(pm.size(), pageImage.size());
+      QVERIFY(pm == pageImage);
+      QVERIFY(score->layoutMode() == LayoutMode::LINE);
+      QVERIFY(!score->undo()->active());
+      QCOMPARE(score->undo()->canRedo(), canRedo);
+      QCOMPARE(score->undo()->isClean(), clean);
+      QCOMPARE(score->systems()->size(), systems);
+      }
+
+//---------------------------------------------------------
+//   lineModeSpanners
+//    the measures written for a thumbnail in line mode end
+//    inside a slur, a hairpin, an ottava and a chain of
+//    ties; the thumbnail must be the one of page mode
+//---------------------------------------------------------
+
+void TestThumbnail::lineModeSpanners()
+      {
+      Score* s = readScore(DIR + "thumbnail-1.mscx");
+      s->setLayoutMode(LayoutMode::LINE);
+      s->doLayout();
+      MeasureBase* end = s->firstPageEnd();
+      QVERIFY(end);
+      QCOMPARE(int(s->spanner().size()), 3);
+      for (auto i : s->spanner())
+            QVERIFY(i.second->tick() < end->tick() && i.second->tick2() >= end->tick());
+      QImage lineImage = s->createThumbnail();
+
+      s->setLayoutMode(LayoutMode::PAGE);
+      s->doLayout();
+      QVERIFY(s->npages() > 1);
+      QImage pageImage = s->createThumbnail();
+
+      QVERIFY(!lineImage.isNull());
+      QCOMPARE(lineImage.size(), pageImage.size());
+      QVERIFY(lineImage == pageImage);
+      delete s;
+      }
+
+//---------------------------------------------------------
+//   benchmarkLineMode
+//---------------------------------------------------------
+
+void TestThumbnail::benchmarkLineMode()
+      {
+      score->setLayoutMode(LayoutMode::LINE);
+      score->doLayout();
+      QBENCHMARK {
+            score->createThumbnail();
+            }
+      }
+
+QTEST_MAIN(TestThumbnail)
+#include "tst_thumbnail.moc"
@@ -0,0 +1,225 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2015 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+#include "libmscore/score.h"
+#include "libmscore/measure.h"
+#include "libmscore/segment.h"
+#include "libmscore/chordrest.h"
+#include "libmscore/undo.h"
+
+#define DIR QString("libmscore/midi/")
+
+using namespace Ms;
+
+static const int MEASURES = 5000;
+
+//---------------------------------------------------------
+//   TestTickIndex
+//    tick to measure and note lookup on a long score
+//---------------------------------------------------------
+
+class TestTickIndex : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      Score* score;
+
+      Measure* refTick2measure(int tick) const;
+      ChordRest* refSearchNote(int tick, int track) const;
+      void compare();
+
+   private slots:
+      void initTestCase();
+      void cleanupTestCase();
+      void tick2measure();
+      void insertMeasure();
+      void deleteRange();
+      void benchmarkTick2measure();
+      void benchmarkSearchNote();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestTickIndex::initTestCase()
+      {
+      initMTest();
+      score = readScore(DIR + "testAndanteExcerpts.mscx");
+      QVERIFY(score);
+      score->doLayout();
+      score->startCmd();
+      score->appendMeasures(MEASURES - score->nmeasures());
+      score->endCmd();
+      QCOMPARE(score->nmeasures(), MEASURES);
+      }
+
+//---------------------------------------------------------
+//   cleanupTestCase
+//---------------------------------------------------------
+
+void TestTickIndex::cleanupTestCase()
+      {
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   refTick2measure
+//    linear reference implementation
+//---------------------------------------------------------
+
+Measure* TestTickIndex::refTick2measure(int tick) const
+      {
+      Measure* lm = 0;
+      for (Measure* m = score->firstMeasure(); m; m = m->nextMeasure()) {
+            if (tick < m->tick())
+                  return lm;
+            lm = m;
+            }
+      if (lm && (tick >= lm->tick()) && (tick <= lm->endTick()))
+            return lm;
+      return 0;
+      }
+
+//---------------------------------------------------------
+//   refSearchNote
+//    linear reference implementation
+//---------------------------------------------------------
+
+ChordRest* TestTickIndex::refSearchNote(int tick, int track) const
+      {
+      ChordRest* ipe = 0;
+      Segment::Type st = Segment::Type::ChordRest;
+      for (Segment* segment = score->firstSegment(st); segment; segment = segment->next1(st)) {
+            ChordRest* cr = static_cast<ChordRest*>(segment->element(track));
+            if (!cr)
+                  continue;
+            if (cr->tick() == tick)
+                  return cr;
+            if (cr->tick() >  tick)
+                  return ipe ? ipe : cr;
+            ipe = cr;
+            }
+      return 0;
+      }
+
+//---------------------------------------------------------
+//   compare
+//    compare lookups in every 37th measure with the
+//    reference implementations
+//---------------------------------------------------------
+
+void TestTickIndex::compare()
+      {
+      int i = 0;
+      for (Measure* m = score->firstMeasure(); m; m = m->nextMeasure(), ++i) {
+            if (i % 37 && m->nextMeasure())
+                  continue;
+            for (int tick : { m->tick(), m->tick() + m->ticks() / 3, m->endTick() }) {
+                  QCOMPARE(score->tick2measure(tick), refTick2measure(tick));
+                  for (int track : { 0, 1, 4 })
+                        QCOMPARE(score->searchNote(tick, track), refSearchNote(tick, track));
+                  }
+            }
+      }
+
+//---------------------------------------------------------
+//   tick2measure
+//---------------------------------------------------------
+
+void TestTickIndex::tick2measure()
+      {
+      compare();
+      for (Measure* m = score->firstMeasure(); m; m = m->nextMeasure()) {
+            QCOMPARE(score->tick2measure(m->tick()), m);
+            QCOMPARE(score->tick2measure(m->endTick() - 1), m);
+            ChordRest* cr = score->searchNote(m->tick(), 0);
+            QVERIFY(cr);
+            QCOMPARE(cr->tick(), m->tick());
+            }
+      QCOMPARE(score->tick2measure(-1), score->lastMeasure());
+      QCOMPARE(score->tick2measure(score->lastMeasure()->endTick() + 1), (Measure*)0);
+      }
+
+//---------------------------------------------------------
+//   insertMeasure
+//    the index must follow insertion, undo and redo
+//---------------------------------------------------------
+
+void TestTickIndex::insertMeasure()
+      {
+      Measure* m = score->firstMeasure();
+      for (int i = 0; i < MEASURES / 2; ++i)
+            m = m->nextMeasure();
+      score->startCmd();
+      score->insertMeasure(Element::Type::MEASURE, m);
+      score->endCmd();
+      QCOMPARE(score->nmeasures(), MEASURES + 1);
+      compare();
+
+      score->undo()->undo();
+      score->endUndoRedo();
+      QCOMPARE(score->nmeasures(), MEASURES);
+      compare();
+
+      score->undo()->redo();
+      score->endUndoRedo();
+      compare();
+      score->undo()->undo();
+      score->endUndoRedo();
+      }
+
+//---------------------------------------------------------
+//   deleteRange
+//    chords replaced by rests must be found
+//---------------------------------------------------------
+
+void TestTickIndex::deleteRange()
+      {
+      compare();
+      score->startCmd();
+      score->select(score->firstMeasure(), SelectType::RANGE, 0);
+      score->cmdDeleteSelection();
+      score->endCmd();
+      compare();
+
+      score->undo()->undo();
+      score->endUndoRedo();
+      compare();
+      }
+
+//---------------------------------------------------------
+//   benchmarks
+//---------------------------------------------------------
+
+void TestTickIndex::benchmarkTick2measure()
+      {
+      int endTick = score->lastMeasure()->endTick();
+      QBENCHMARK {
+            for (int tick = 0; tick < endTick; tick += 240)
+                  QVERIFY(score->tick2measure(tick));
+            }
+      }
+
+void TestTickIndex::benchmarkSearchNote()
+      {
+      int endTick = score->lastMeasure()->endTick();
+      QBENCHMARK {
+            for (int tick = 0; tick < endTick; tick += 1920)
+                  QVERIFY(score->searchNote(tick, 0));
+            }
+      }
+
+QTEST_MAIN(TestTickIndex)
+#include "tst_tickindex.moc"
@@ -42,6 +42,7 @@ class TestMxmlIO : public QObject, public MTest
       void mxmlMscxExportTestRef(const char* file);
       void mxmlReadTestCompr(const char* file);
       void mxmlReadWriteTestCompr(const char* file);
+      Score* readInvalidSchema(bool validate);
 
 
       // The list of MusicXML regression tests
@@ -159,6 +160,8 @@ private slots:
 //      void wedge2() { mxmlIoTest("testWedge2"); }
       void words1() { mxmlIoTest("testWords1"); }
       void words2() { mxmlIoTest("testWords2"); }
+      void validationOn();
+      void validationOff();
       };
 
 //---------------------------------------------------------
@@ -324,5 +327,60 @@ void TestMxmlIO::mxmlReadWriteTestCompr(const char* file)
       delete score;
       }
 
+//---------------------------------------------------------
+//   readInvalidSchema
+//   read a well-formed MusicXML file which does not match
+//   the schema with or without validation
+//---------------------------------------------------------
+
+Score* TestMxmlIO::readInvalidSchema(bool validate)
+      {
+      MScore::debugMode = true;
+      MScore::lastError.clear();
+      preferences.musicxmlImportValidate = validate;
+      Score* score = readScore(DIR + "testInvalidSchema.xml");
+      preferences.musicxmlImportValidate = true;
+      return score;
+      }
+
+//---------------------------------------------------------
+//   validationOn
+//   an invalid file is reported; in converter mode it is
+//   imported anyhow
+//---------------------------------------------------------
+
+void TestMxmlIO::validationOn()
+      {
+      Score* score = readInvalidSchema(true);
+      QVERIFY(score);
+      QVERIFY(MScore::lastError.contains("not a valid MusicXML file"));
+      delete score;
+
+      MScore::lastError.clear();
+      score = readScore(DIR + "testHello.xml");
+      QVERIFY(score);
+      QVERIFY(MScore::lastError.isEmpty());
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   validationOff
+//   without validation (--no-musicxml-validation) the same
+//   file is imported without a report
+//---------------------------------------------------------
+
+void TestMxmlIO::validationOff()
+      {
+      preferences.musicxmlExportBreaks = MusicxmlExportBreaks::MANUAL;
+      preferences.musicxmlImportBreaks = true;
+      Score* score = readInvalidSchema(false);
+      QVERIFY(score);
+      QVERIFY(MScore::lastError.isEmpty());
+      fixupScore(score);
+      score->doLayout();
+      QVERIFY(saveCompareMusicXmlScore(score, "testInvalidSchema.xml", DIR + "testHello.xml"));
+      delete score;
+      }
+
 QTEST_MAIN(TestMxmlIO)
 #include "tst_mxml_io.moc"
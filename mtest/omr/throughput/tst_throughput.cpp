@@ -0,0 +1,147 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2015 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+#include "libmscore/score.h"
+#include "libmscore/page.h"
+#include "omr/pattern.h"
+
+#define DIR QString("omr/notes/")
+
+using namespace Ms;
+
+static const int COPIES = 8;     // copies of the score in the benchmark pdf
+
+//---------------------------------------------------------
+//   TestThroughput
+//---------------------------------------------------------
+
+class TestThroughput : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      int savePages(Score*, const QString& name, int copies);
+
+   private slots:
+      void initTestCase();
+      void patternMatch();
+      void pagesPerSecond();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestThroughput::initTestCase()
+      {
+      initMTest();
+      }
+
+//---------------------------------------------------------
+//   refMatch
+//    pixel by pixel reference implementation
+//---------------------------------------------------------
+
+static double refMatch(const Pattern* p, const QImage* img, int col, int row)
+      {
+      int k = 0;
+      for (int y = 0; y < p->h(); ++y) {
+            for (int x = 0; x < p->w(); ++x) {
+                  if (p->image()->pixelIndex(x, y) != img->pixelIndex(col + x, row + y))
+                        ++k;
+                  }
+            }
+      return 1.0 - (double(k) / (p->h() * p->w()));
+      }
+
+//---------------------------------------------------------
+//   patternMatch
+//    the word wide kernel must count exactly the pixels
+//    which differ, for every alignment and up to the end
+//    of the scan line
+//---------------------------------------------------------
+
+void TestThroughput::patternMatch()
+      {
+      QImage img(333, 64, QImage::Format_MonoLSB);
+      qsrand(4711);
+      for (int y = 0; y < img.height(); ++y) {
+            uchar* p = img.scanLine(y);
+            for (int i = 0; i < img.bytesPerLine(); ++i)
+                  *p++ = qrand() & 0xff;
+            }
+      for (int w : { 7, 32, 45, 70 }) {
+            Pattern pattern(&img, 11, 3, w, 20);
+            QCOMPARE(pattern.match(&img, 11, 3), 1.0);
+            QCOMPARE(pattern.match(&pattern), 1.0);
+            for (int col = 0; col <= img.width() - w; col += 3) {
+                  for (int row = 0; row <= img.height() - 20; row += 11)
+                        QCOMPARE(pattern.match(&img, col, row), refMatch(&pattern, &img, col, row));
+                  }
+            }
+      }
+
+//---------------------------------------------------------
+//   savePages
+//    print copies of all pages of the score into one pdf,
+//    return the number of pages
+//---------------------------------------------------------
+
+int TestThroughput::savePages(Score* score, const QString& name, int copies)
+      {
+      QPrinter printerDev(QPrinter::HighResolution);
+      printerDev.setPaperSize(score->pageFormat()->size(), QPrinter::Inch);
+      printerDev.setFullPage(true);
+      printerDev.setOutputFormat(QPrinter::PdfFormat);
+      printerDev.setOutputFileName(name);
+
+      QPainter p(&printerDev);
+      double mag = printerDev.logicalDpiX() / MScore::DPI;
+      p.scale(mag, mag);
+      int pages = 0;
+      for (int copy = 0; copy < copies; ++copy) {
+            for (int n = 0; n < score->npages(); ++n) {
+                  if (pages++)
+                        printerDev.newPage();
+                  score->print(&p, n);
+                  }
+            }
+      p.end();
+      return pages;
+      }
+
+//---------------------------------------------------------
+//   pagesPerSecond
+//    recognize a multi page pdf and report the throughput
+//---------------------------------------------------------
+
+void TestThroughput::pagesPerSecond()
+      {
+      Score* score = readScore(DIR + "notes1.mscx");
+      QVERIFY(score);
+      score->doLayout();
+      int pages = savePages(score, "throughput.pdf", COPIES);
+      delete score;
+
+      QElapsedTimer timer;
+      timer.start();
+      Score* score1 = readCreatedScore("throughput.pdf");
+      qint64 ms = timer.elapsed();
+      QVERIFY(score1);
+      delete score1;
+
+      qDebug("%d pages in %lld ms: %.2f pages/s", pages, ms, ms ? pages * 1000.0 / ms : 0.0);
+      }
+
+QTEST_MAIN(TestThroughput)
+#include "tst_throughput.moc"
@@ -0,0 +1,593 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2015 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <functional>
+#include <QtTest/QtTest>
+#include <QSvgGenerator>
+#include "config.h"
+#include "mtest/testutils.h"
+#include "libmscore/score.h"
+#include "libmscore/measure.h"
+#include "libmscore/segment.h"
+#include "libmscore/chord.h"
+#include "libmscore/note.h"
+#include "libmscore/page.h"
+#include "libmscore/instrument.h"
+#include "libmscore/mcursor.h"
+#include "libmscore/durationtype.h"
+#include "synthesizer/event.h"
+#include "fluid/fluid.h"
+#ifdef ZERBERUS
+#include "zerberus/zerberus.h"
+#endif
+#include "mscore/preferences.h"
+
+using namespace Ms;
+
+namespace Ms {
+extern Score::FileError importMusicXml(Score*, const QString&);
+extern bool saveXml(Score*, const QString&);
+}
+
+static const int SYNTHETIC_MEASURES = 500;
+static const int AUDIO_SECONDS      = 60;   // audio rendered per iteration
+static const int AUDIO_SAMPLERATE   = 44100;
+static const qint64 MAX_TIME        = 2000; // ms per benchmark, at least one iteration
+
+//---------------------------------------------------------
+//   Result
+//---------------------------------------------------------
+
+struct Result {
+      QString name;
+      QString fixture;
+      int iterations;
+      double mean;            // ms
+      double min;             // ms
+      };
+
+//---------------------------------------------------------
+//   TestPerformance
+//    timings of the main hot paths on a synthetic and a
+//    real score. Results are written to benchmark.json and
+//    benchmark.csv in the working directory.
+//---------------------------------------------------------
+
+class TestPerformance : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      QMap<QString, Score*> scores;
+      QMap<QString, QString> paths;
+      QList<Result> results;
+
+      Score* createSynthetic();
+      void fixtures();
+      Score* fixtureScore();
+      void measure(std::function<void()> f, int iterations, std::function<void()> setup = nullptr);
+      void renderAudio(Synthesizer*, Score*, const EventMap&);
+      void writeResults();
+
+   private slots:
+      void initTestCase();
+      void cleanupTestCase();
+
+      void load_data()              { fixtures(); }
+      void load();
+      void layoutCold_data()        { fixtures(); }
+      void layoutCold();
+      void layoutWarm_data()        { fixtures(); }
+      void layoutWarm();
+      void relayoutNote_data()      { fixtures(); }
+      void relayoutNote();
+      void renderMidi_data()        { fixtures(); }
+      void renderMidi();
+      void musicXmlExport_data()    { fixtures(); }
+      void musicXmlExport();
+      void musicXmlImport_data()    { fixtures(); }
+      void musicXmlImport();
+      void pdfExport_data()         { fixtures(); }
+      void pdfExport();
+      void pngExport_data()         { fixtures(); }
+      void pngExport();
+      void svgExport_data()         { fixtures(); }
+      void svgExport();
+      void saveCompressed_data()    { fixtures(); }
+      void saveCompressed();
+      void audioExport_data()       { fixtures(); }
+      void audioExport();
+      void zerberusRender_data()    { fixtures(); }
+      void zerberusRender();
+      };
+
+//---------------------------------------------------------
+//   createSynthetic
+//    four parts with running eighth notes
+//---------------------------------------------------------
+
+Score* TestPerformance::createSynthetic()
+      {
+      static const char* instruments[] = { "flute", "trumpet", "violin", "violoncello" };
+      MCursor c;
+      c.setTimeSig(Fraction(4,4));
+      c.createScore("synthetic");
+      for (const char* instrument : instruments)
+            c.addPart(instrument);
+      for (int staffIdx = 0; staffIdx < 4; ++staffIdx) {
+            c.move(staffIdx * VOICES, 0);
+            if (staffIdx == 0) {
+                  c.addKeySig(Key(2));
+                  c.addTimeSig(Fraction(4,4));
+                  }
+            int base = 72 - staffIdx * 7;
+            for (int i = 0; i < SYNTHETIC_MEASURES * 8; ++i)
+                  c.addChord(base + (i * 5) % 12, TDuration(TDuration::DurationType::V_EIGHTH));
+            }
+      Score* score = c.score();
+      score->doLayout();
+      score->rebuildMidiMapping();
+      return score;
+      }
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestPerformance::initTestCase()
+      {
+      initMTest();
+      preferences.sfPath = root + "/../share/sound";
+
+      Score* score = createSynthetic();
+      QFile fp("synthetic.mscx");
+      QVERIFY(fp.open(QIODevice::WriteOnly));
+      score->saveFile(&fp, false);
+      fp.close();
+      scores["synthetic"] = score;
+      paths["synthetic"]  = "synthetic.mscx";
+
+      score = readScore("../demos/goldberg.mscz");
+      QVERIFY(score);
+      score->doLayout();
+      scores["goldberg"] = score;
+      paths["goldberg"]  = root + "/../demos/goldberg.mscz";
+      }
+
+//---------------------------------------------------------
+//   cleanupTestCase
+//---------------------------------------------------------
+
+void TestPerformance::cleanupTestCase()
+      {
+      writeResults();
+      qDeleteAll(scores);
+      }
+
+//---------------------------------------------------------
+//   fixtures
+//---------------------------------------------------------
+
+void TestPerformance::fixtures()
+      {
+      QTest::addColumn<QString>("fixture");
+      QTest::newRow("synthetic") << "synthetic";
+      QTest::newRow("goldberg") << "goldberg";
+      }
+
+Score* TestPerformance::fixtureScore()
+      {
+      QFETCH(QString, fixture);
+      return scores[fixture];
+      }
+
+//---------------------------------------------------------
+//   measure
+//    call f until MAX_TIME is used up or iterations are
+//    done; setup is called before every iteration and is
+//    not timed
+//---------------------------------------------------------
+
+void TestPerformance::measure(std::function<void()> f, int iterations, std::function<void()> setup)
+      {
+      QElapsedTimer total;
+      total.start();
+      double sum = 0.0;
+      double min = 0.0;
+      int n = 0;
+      while (n < iterations && (n == 0 || total.elapsed() < MAX_TIME)) {
+            if (setup)
+                  setup();
+            QElapsedTimer timer;
+            timer.start();
+            f();
+            double ms = timer.nsecsElapsed() / 1000000.0;
+            sum += ms;
+            min = n ? qMin(min, ms) : ms;
+            ++n;
+            }
+      Result r { QTest::currentTestFunction(), QTest::currentDataTag(), n, sum / n, min };
+      results.append(r);
+      qDebug("%s/%s: %d iterations, mean %.2f ms, min %.2f ms",
+         qPrintable(r.name), qPrintable(r.fixture), r.iterations, r.mean, r.min);
+      }
+
+//---------------------------------------------------------
+//   writeResults
+//---------------------------------------------------------
+
+void TestPerformance::writeResults()
+      {
+      QJsonArray ja;
+      QFile csv("benchmark.csv");
+      if (!csv.open(QIODevice::WriteOnly | QIODevice::Text)) {
+            qDebug("cannot write benchmark.csv");
+            return;
+            }
+      QTextStream ts(&csv);
+      ts << "version,benchmark,fixture,iterations,mean_ms,min_ms\n";
+      for (const Result& r : results) {
+            ts << VERSION << ',' << r.name << ',' << r.fixture << ',' << r.iterations << ','
+               << QString::number(r.mean, 'f', 3) << ',' << QString::number(r.min, 'f', 3) << '\n';
+            QJsonObject o;
+            o["benchmark"]  = r.name;
+            o["fixture"]    = r.fixture;
+            o["iterations"] = r.iterations;
+            o["mean_ms"]    = r.mean;
+            o["min_ms"]     = r.min;
+            ja.append(o);
+            }
+      csv.close();
+
+      QJsonObject jo;
+      jo["version"] = QString(VERSION);
+      jo["date"]    = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+      jo["threads"] = QThread::idealThreadCount();
+      jo["results"] = ja;
+      QFile json("benchmark.json");
+      if (json.open(QIODevice::WriteOnly))
+            json.write(QJsonDocument(jo).toJson());
+      }
+
+//---------------------------------------------------------
+//   load
+//---------------------------------------------------------
+
+void TestPerformance::load()
+      {
+      QFETCH(QString, fixture);
+      QString path = paths[fixture];
+      measure([&] {
+            Score* score = new Score(mscore->baseStyle());
+            score->loadMsc(path, false);
+            delete score;
+            }, 10);
+      }
+
+//---------------------------------------------------------
+//   layoutCold
+//    first layout of a freshly loaded score
+//---------------------------------------------------------
+
+void TestPerformance::layoutCold()
+      {
+      QFETCH(QString, fixture);
+      QString path = paths[fixture];
+      Score* score = 0;
+      measure([&] { score->doLayout(); }, 5, [&] {
+            delete score;
+            score = new Score(mscore->baseStyle());
+            score->loadMsc(path, false);
+            });
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   layoutWarm
+//---------------------------------------------------------
+
+void TestPerformance::layoutWarm()
+      {
+      Score* score = fixtureScore();
+      measure([&] { score->doLayout(); }, 20);
+      }
+
+//---------------------------------------------------------
+//   relayoutNote
+//    change the pitch of one note in the middle of the
+//    score, as the editor does
+//---------------------------------------------------------
+
+void TestPerformance::relayoutNote()
+      {
+      Score* score = fixtureScore();
+      Note* note = 0;
+      Measure* m = score->firstMeasure();
+      for (int i = 0; i < score->nmeasures() / 2 && m; ++i)
+            m = m->nextMeasure();
+      for (Segment* s = m ? m->first(Segment::Type::ChordRest) : 0; s && !note; s = s->next(Segment::Type::ChordRest)) {
+            for (int track = 0; track < score->ntracks() && !note; ++track) {
+                  Element* e = s->element(track);
+                  if (e && e->type() == Element::Type::CHORD)
+                        note = static_cast<Chord*>(e)->upNote();
+                  }
+            }
+      QVERIFY(note);
+      int step = 1;
+      measure([&] {
+            score->startCmd();
+            score->undoChangePitch(note, note->pitch() + step, note->tpc1(), note->tpc2());
+            score->endCmd();
+            step = -step;
+            }, 50);
+      }
+
+//---------------------------------------------------------
+//   renderMidi
+//---------------------------------------------------------
+
+void TestPerformance::renderMidi()
+      {
+      Score* score = fixtureScore();
+      measure([&] {
+            EventMap events;
+            score->renderMidi(&events);
+            }, 20);
+      }
+
+//---------------------------------------------------------
+//   musicXmlExport
+//---------------------------------------------------------
+
+void TestPerformance::musicXmlExport()
+      {
+      QFETCH(QString, fixture);
+      Score* score = fixtureScore();
+      measure([&] { saveXml(score, fixture + ".xml"); }, 10);
+      }
+
+//---------------------------------------------------------
+//   musicXmlImport
+//    reads the file written by musicXmlExport
+//---------------------------------------------------------
+
+void TestPerformance::musicXmlImport()
+      {
+      QFETCH(QString, fixture);
+      QString path = fixture + ".xml";
+      QVERIFY(QFileInfo(path).exists());
+      measure([&] {
+            Score* score = new Score(mscore->baseStyle());
+            importMusicXml(score, path);
+            delete score;
+            }, 10);
+      }
+
+//---------------------------------------------------------
+//   pdfExport
+//---------------------------------------------------------
+
+void TestPerformance::pdfExport()
+      {
+      QFETCH(QString, fixture);
+      Score* score = fixtureScore();
+      measure([&] { savePdf(score, fixture + ".pdf"); }, 5);
+      }
+
+//---------------------------------------------------------
+//   pngExport
+//    all pages at 300 dpi
+//---------------------------------------------------------
+
+void TestPerformance::pngExport()
+      {
+      Score* score = fixtureScore();
+      measure([&] {
+            double mag = 300.0 / MScore::DPI;
+            for (int i = 0; i < score->npages(); ++i) {
+                  QRectF r = score->pages().at(i)->abbox();
+                  QImage image(lrint(r.width() * mag), lrint(r.height() * mag), QImage::Format_ARGB32_Premultiplied);
+                  image.fill(0xffffffff);
+                  QPainter p(&image);
+                  p.setRenderHint(QPainter::Antialiasing, true);
+                  p.setRenderHint(QPainter::TextAntialiasing, true);
+                  p.scale(mag, mag);
+                  score->print(&p, i);
+                  p.end();
+                  QBuffer buffer;
+                  buffer.open(QIODevice::WriteOnly);
+                  image.save(&buffer, "PNG");
+                  }
+            }, 3);
+      }
+
+//---------------------------------------------------------
+//   svgExport
+//---------------------------------------------------------
+
+void TestPerformance::svgExport()
+      {
+      Score* score = fixtureScore();
+      measure([&] {
+            for (int i = 0; i < score->npages(); ++i) {
+                  QRectF r = score->pages().at(i)->abbox();
+                  QBuffer buffer;
+                  QSvgGenerator svg;
+                  svg.setOutputDevice(&buffer);
+                  svg.setSize(QSize(lrint(r.width()), lrint(r.height())));
+                  svg.setViewBox(r);
+                  QPainter p(&svg);
+                  score->print(&p, i);
+                  p.end();
+                  }
+            }, 5);
+      }
+
+//---------------------------------------------------------
+//   saveCompressed
+//---------------------------------------------------------
+
+void TestPerformance::saveCompressed()
+      {
+      QFETCH(QString, fixture);
+      Score* score = fixtureScore();
+      QFileInfo fi(fixture + ".mscz");
+      measure([&] {
+            QBuffer buffer;
+            buffer.open(QIODevice::WriteOnly);
+            score->saveCompressedFile(&buffer, fi, false);
+            }, 10);
+      }
+
+//---------------------------------------------------------
+//   audioExport
+//    render the first AUDIO_SECONDS of the score with the
+//    default soundfont, as the audio export does
+//---------------------------------------------------------
+
+void TestPerformance::audioExport()
+      {
+      Score* score = fixtureScore();
+      FluidS::Fluid fluid;
+      fluid.init(AUDIO_SAMPLERATE);
+      if (!fluid.loadSoundFonts(QStringList("FluidR3Mono_GM.sf3")))
+            QSKIP("soundfont not available");
+
+      EventMap events;
+      score->renderMidi(&events);
+      QVERIFY(!events.empty());
+      measure([&] { renderAudio(&fluid, score, events); }, 3);
+      }
+
+//---------------------------------------------------------
+//   writeWav
+//    write frames of a 16 bit wav file with a decaying
+//    sine wave
+//---------------------------------------------------------
+
+#ifdef ZERBERUS
+static bool writeWav(const QString& path, int channels, int frames)
+      {
+      QFile f(path);
+      if (!f.open(QIODevice::WriteOnly))
+            return false;
+      QDataStream ds(&f);
+      ds.setByteOrder(QDataStream::LittleEndian);
+      quint32 bytes = frames * channels * sizeof(qint16);
+      ds.writeRawData("RIFF", 4);
+      ds << quint32(36 + bytes);
+      ds.writeRawData("WAVEfmt ", 8);
+      ds << quint32(16) << quint16(1) << quint16(channels) << quint32(AUDIO_SAMPLERATE)
+         << quint32(AUDIO_SAMPLERATE * channels * sizeof(qint16)) << quint16(channels * sizeof(qint16)) << quint16(16);
+      ds.writeRawData("data", 4);
+      ds << bytes;
+      for (int i = 0; i < frames; ++i) {
+            double v = sin(2.0 * M_PI * 261.63 * i / AUDIO_SAMPLERATE) * exp(-double(i) / frames);
+            for (int k = 0; k < channels; ++k)
+                  ds << qint16(lrint(v * (k ? 20000.0 : 24000.0)));
+            }
+      return f.error() == QFile::NoError;
+      }
+#endif
+
+//---------------------------------------------------------
+//   zerberusRender
+//    render the score with an sfz instrument made of a
+//    mono and a stereo sample; this times the voice
+//    interpolation of Zerberus
+//---------------------------------------------------------
+
+void TestPerformance::zerberusRender()
+      {
+#ifdef ZERBERUS
+      Score* score = fixtureScore();
+      QTemporaryDir dir;
+      QVERIFY(dir.isValid());
+      QVERIFY(writeWav(dir.path() + "/mono.wav", 1, 4 * AUDIO_SAMPLERATE));
+      QVERIFY(writeWav(dir.path() + "/stereo.wav", 2, 4 * AUDIO_SAMPLERATE));
+      QFile sfz(dir.path() + "/bench.sfz");
+      QVERIFY(sfz.open(QIODevice::WriteOnly | QIODevice::Text));
+      sfz.write("<region> sample=mono.wav lokey=0 hikey=63 pitch_keycenter=60\n"
+                "<region> sample=stereo.wav lokey=64 hikey=127 pitch_keycenter=72\n");
+      sfz.close();
+
+      QString sfPath = preferences.sfPath;
+      preferences.sfPath = dir.path();
+      Zerberus zerberus;
+      zerberus.init(AUDIO_SAMPLERATE);
+      bool loaded = zerberus.addSoundFont("bench.sfz");
+      preferences.sfPath = sfPath;
+      QVERIFY(loaded);
+
+      EventMap events;
+      score->renderMidi(&events);
+      QVERIFY(!events.empty());
+      measure([&] { renderAudio(&zerberus, score, events); }, 3);
+#else
+      QSKIP("Zerberus not built");
+#endif
+      }
+
+//---------------------------------------------------------
+//   renderAudio
+//    play AUDIO_SECONDS of the events of score with synth
+//    like the audio export does
+//---------------------------------------------------------
+
+void TestPerformance::renderAudio(Synthesizer* synth, Score* score, const EventMap& events)
+      {
+      static const unsigned FRAMES = 512;
+
+      synth->allSoundsOff(-1);
+      for (const MidiMapping& mm : *score->midiMapping()) {
+            const Ms::Channel* a = mm.articulation;   // Zerberus has a Channel, too
+            a->updateInitList();
+            for (MidiCoreEvent e : a->init) {
+                  if (e.type() == ME_INVALID)
+                        continue;
+                  e.setChannel(a->channel);
+                  synth->play(e);
+                  }
+            }
+      float buffer[FRAMES * 2];
+      float effect1[FRAMES * 2];
+      float effect2[FRAMES * 2];
+      int playTime = 0;
+      auto playPos = events.cbegin();
+      while (playTime < AUDIO_SECONDS * AUDIO_SAMPLERATE) {
+            unsigned frames = FRAMES;
+            float* p = buffer;
+            memset(buffer, 0, sizeof(buffer));
+            int endTime = playTime + frames;
+            for (; playPos != events.cend(); ++playPos) {
+                  int f = score->utick2utime(playPos->first) * AUDIO_SAMPLERATE;
+                  if (f >= endTime)
+                        break;
+                  int n = f - playTime;
+                  if (n) {
+                        synth->process(n, p, effect1, effect2);
+                        p += 2 * n;
+                        }
+                  playTime += n;
+                  frames   -= n;
+                  if (playPos->second.isChannelEvent())
+                        synth->play(playPos->second);
+                  }
+            if (frames) {
+                  synth->process(frames, p, effect1, effect2);
+                  playTime += frames;
+                  }
+            playTime = endTime;
+            }
+      }
+
+QTEST_MAIN(TestPerformance)
+#include "tst_performance.moc"
@@ -328,6 +328,7 @@ void MTest::initMTest()
       new MuseScoreCore;
       mscore->init();
       preferences.shortestNote = MScore::division / 4; // midi quantization: 1/16
+      preferences.musicxmlImportValidate = true;       // default of the application
 
       root = TESTROOT "/mtest";
       loadInstrumentTemplates(":/instruments.xml");
@@ -164,8 +164,29 @@ bool Omr::readPdf()
       return true;
       }
 
+//---------------------------------------------------------
+//   readPage
+//---------------------------------------------------------
+
+static void readPage(OmrPage*& page)
+      {
+      page->read();
+      }
+
+//---------------------------------------------------------
+//   searchBarLines
+//---------------------------------------------------------
+
+static void searchBarLines(OmrSystem*& system)
+      {
+      system->searchBarLines();
+      }
+
 //---------------------------------------------------------
 //   process
+//    pages are read in parallel, then the systems of all
+//    pages are searched for bar lines and notes in one
+//    parallel pass
 //---------------------------------------------------------
 
 void Omr::process()
@@ -175,8 +196,8 @@ void Omr::process()
 
       int pages = 0;
       int n = _pages.size();
+      QtConcurrent::blockingMap(_pages, readPage);
       for (int i = 0; i < n; ++i) {
-            _pages[i]->read();
             if (_pages[i]->systems().size() > 0) {
                   sp += _pages[i]->spatium();
                   ++pages;
@@ -197,6 +218,13 @@ void Omr::process()
       trebleclefPattern = new Pattern(trebleclefSym, &symbols[0][trebleclefSym],  _spatium);
       bassclefPattern   = new Pattern(bassclefSym, &symbols[0][bassclefSym],  _spatium);
 
+      QList<OmrSystem*> systems;
+      for (OmrPage* page : _pages) {
+            for (OmrSystem& system : page->systems())
+                  systems.append(&system);
+            }
+      QtConcurrent::blockingMap(systems, searchBarLines);
+
       for (int i = 0; i < n; ++i) {
             OmrPage* page = _pages[i];
             if (!page->systems().isEmpty()) {
@@ -125,13 +125,12 @@ void OmrPage::read()
 
 //---------------------------------------------------------
 //   readBarLines
+//    build measures from the bar lines and notes found by
+//    OmrSystem::searchBarLines()
 //---------------------------------------------------------
 
 void OmrPage::readBarLines(int pageNo)
       {
-      QFuture<void> bl = QtConcurrent::map(_systems, &OmrSystem::searchBarLines);
-      bl.waitForFinished();
-
       int numStaves    = staves.size();
       int stavesSystem = 2;
       int systems = numStaves / stavesSystem;
@@ -37,6 +37,43 @@ Pattern::~Pattern()
       {
       }
 
+//---------------------------------------------------------
+//   bitsSet
+//    number of bits set in v; compiles to a single
+//    popcnt instruction where the target supports it
+//---------------------------------------------------------
+
+static inline int bitsSet(quint32 v)
+      {
+#ifdef __GNUC__
+      return __builtin_popcount(v);
+#else
+      return Omr::bitsSetTable[v & 0xff]
+           + Omr::bitsSetTable[(v >> 8) & 0xff]
+           + Omr::bitsSetTable[(v >> 16) & 0xff]
+           + Omr::bitsSetTable[v >> 24];
+#endif
+      }
+
+//---------------------------------------------------------
+//   imageBits
+//    return the 32 pixels of a MonoLSB scan line starting
+//    at pixel col; pixels beyond the end of the line are 0
+//---------------------------------------------------------
+
+static inline quint32 imageBits(const uchar* line, int bytes, int col)
+      {
+      int offset = col >> 3;
+      quint64 v  = 0;
+      if (offset + 8 <= bytes)
+            v = qFromLittleEndian<quint64>(line + offset);
+      else {
+            for (int i = 0; offset + i < bytes; ++i)
+                  v |= quint64(line[offset + i]) << (i * 8);
+            }
+      return quint32(v >> (col & 7));
+      }
+
 //---------------------------------------------------------
 //   patternMatch
 //    compare two patterns for similarity
@@ -54,39 +91,36 @@ double Pattern::match(const Pattern* a) const
       int k = 0;
       const uchar* p1 = image()->bits();
       const uchar* p2 = a->image()->bits();
-      for (int i = 0; i < n; ++i) {
-            uchar v = (*(p1++)) ^ (*(p2++));
-            k += Omr::bitsSetTable[v];
-            }
+      for (int i = 0; i < n; i += 4)
+            k += bitsSet(qFromLittleEndian<quint32>(p1 + i) ^ qFromLittleEndian<quint32>(p2 + i));
       return 1.0 - (double(k) / (h() * w()));
       }
 
+//---------------------------------------------------------
+//   match
+//    compare the pattern with the image at col/row, 32
+//    pixels at a time
+//---------------------------------------------------------
+
 double Pattern::match(const QImage* img, int col, int row) const
       {
       int rows      = h();
-      int bytes     = ((w() + 7) / 8) - 1;
-      int shift     = col & 7;
+      int words     = (w() + 31) / 32;
+      int bytes     = img->bytesPerLine();
+      int rest      = w() & 31;
+      quint32 mask  = rest ? (quint32(1) << rest) - 1 : 0xffffffff;
       int k         = 0;
-      int eshift    = (col + w()) & 7;
 
       for (int y = 0; y < rows; ++y) {
             const uchar* p1 = image()->scanLine(y);
-            const uchar* p2 = img->scanLine(row + y) + (col/8);
-            for (int x = 0; x < bytes; ++x) {
-                  uchar a = *p1++;
-                  uchar b1 = *p2;
-                  uchar b2 = *(p2 + 1);
-                  p2++;
-                  uchar b  = (b1 >> shift) | (b2 << (7 - shift));
-                  uchar v = a ^ b;
-                  k += Omr::bitsSetTable[v];
+            const uchar* p2 = img->scanLine(row + y);
+            for (int x = 0; x < words - 1; ++x) {
+                  quint32 a = qFromLittleEndian<quint32>(p1 + x * 4);
+                  k += bitsSet(a ^ imageBits(p2, bytes, col + x * 32));
                   }
-            uchar a = *p1++;
-            uchar b1 = *p2;
-            uchar b2 = *(p2 + 1) & (0xff << eshift);
-            uchar b  = (b1 >> shift) | (b2 << (7 - shift));
-            uchar v = a ^ b;
-            k += Omr::bitsSetTable[v];
+            quint32 a = qFromLittleEndian<quint32>(p1 + (words - 1) * 4);
+            quint32 b = imageBits(p2, bytes, col + (words - 1) * 32) & mask;
+            k += bitsSet(a ^ b);
             }
       return 1.0 - (double(k) / (h() * w()));
       }
@@ -0,0 +1,136 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2015 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __LOADMETER_H__
+#define __LOADMETER_H__
+
+#include <atomic>
+#include <chrono>
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   LoadMeter
+//    time spent by the audio thread in one stage of a
+//    block, compared to the period of the block.
+//    Only the audio thread calls add(); all other threads
+//    read. A reset() is executed by the audio thread with
+//    the next add(), so no locking is needed.
+//---------------------------------------------------------
+
+class LoadMeter {
+   public:
+      static const int BUCKETS = 11;      // 10% steps of the period, last: late
+
+   private:
+      std::atomic<bool> _reset       { false };
+      std::atomic<unsigned> _count   { 0 };
+      std::atomic<unsigned> _late    { 0 };      // blocks which took longer than their period
+      std::atomic<qint64> _total     { 0 };      // us
+      std::atomic<qint64> _period    { 0 };      // us, sum of all periods
+      std::atomic<qint64> _min       { 0 };
+      std::atomic<qint64> _max       { 0 };
+      std::atomic<unsigned> _histogram[BUCKETS];
+
+      void clear() {
+            _count  = 0;
+            _late   = 0;
+            _total  = 0;
+            _period = 0;
+            _min    = 0;
+            _max    = 0;
+            for (int i = 0; i < BUCKETS; ++i)
+                  _histogram[i] = 0;
+            }
+
+   public:
+      LoadMeter()                 { clear(); }
+
+      static qint64 now() {
+            using namespace std::chrono;
+            return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+            }
+
+      //---------------------------------------------------
+      //   add
+      //    us: time used by the block, period: length of
+      //    the block in us
+      //---------------------------------------------------
+
+      void add(qint64 us, qint64 period) {
+            if (_reset.exchange(false))
+                  clear();
+            if (period <= 0)
+                  return;
+            if (_count == 0 || us < _min)
+                  _min = us;
+            if (us > _max)
+                  _max = us;
+            _total  += us;
+            _period += period;
+            ++_count;
+            if (us > period) {
+                  ++_late;
+                  _histogram[BUCKETS - 1]++;
+                  }
+            else
+                  _histogram[qMin(int(us * (BUCKETS - 1) / period), BUCKETS - 2)]++;
+            }
+
+      void reset()                        { _reset = true; }
+
+      unsigned count() const              { return _count; }
+      unsigned late() const               { return _late; }
+      qint64 min() const                  { return _min; }
+      qint64 max() const                  { return _max; }
+      qint64 avg() const                  { return _count ? _total / _count : 0; }
+      double load() const                 { return _period ? double(_total) / double(_period) : 0.0; }
+      unsigned histogram(int bucket) const { return _histogram[bucket]; }
+
+      //---------------------------------------------------
+      //   report
+      //    one line summary followed by the histogram
+      //---------------------------------------------------
+
+      QString report(const QString& name) const {
+            QString s = QString("%1: %2 blocks, load %3%, min %4 us, avg %5 us, max %6 us, late %7\n")
+               .arg(name, -24).arg(count()).arg(load() * 100.0, 0, 'f', 1)
+               .arg(min()).arg(avg()).arg(max()).arg(late());
+            if (count() == 0)
+                  return s;
+            s += QString("%1  ").arg("", -24);
+            for (int i = 0; i < BUCKETS - 1; ++i)
+                  s += QString(" <%1%:%2").arg((i + 1) * 100 / (BUCKETS - 1)).arg(histogram(i));
+            s += QString(" late:%1\n").arg(histogram(BUCKETS - 1));
+            return s;
+            }
+
+      //---------------------------------------------------
+      //   Timer
+      //    measure the lifetime of a scope
+      //---------------------------------------------------
+
+      class Timer {
+            LoadMeter* _meter;
+            qint64 _period;
+            qint64 _start;
+
+         public:
+            Timer(LoadMeter* m, unsigned frames, float sampleRate)
+               : _meter(m), _period(sampleRate > 0.0f ? qint64(frames * 1000000.0 / sampleRate) : 0), _start(LoadMeter::now()) {}
+            ~Timer() { _meter->add(LoadMeter::now() - _start, _period); }
+            };
+      };
+
+}
+#endif
+
@@ -87,7 +87,7 @@ MasterSynthesizer::~MasterSynthesizer()
       for (Synthesizer* s : _synthesizer)
             delete s;
       for (int i = 0; i < MAX_EFFECTS; ++i)
-            delete _effect[i];
+            delete _effect[i].load();
       }
 
 //---------------------------------------------------------
@@ -215,11 +215,10 @@ void MasterSynthesizer::setEffect(int ab, int idx)
             qDebug("MasterSynthesizer::setEffect: bad idx %d %d", ab, idx);
             return;
             }
-      lock2 = true;
-      while (lock1)
-            sleep(1);
+      // the effects are never deleted while the synthesizer runs,
+      // so the audio thread can switch to the new one at its next
+      // block without any handshake
       _effect[ab] = _effectList[ab][idx];
-      lock2 = false;
       }
 
 //---------------------------------------------------------
@@ -246,8 +245,61 @@ void MasterSynthesizer::setSampleRate(float val)
             e->init(_sampleRate);
       for (Effect* e : _effectList[1])
             e->init(_sampleRate);
-      lock2 = false;
-      lock1 = false;
+      _ready = true;
+      }
+
+//---------------------------------------------------------
+//   xruns
+//    number of audio blocks which could not be processed
+//    and were left silent
+//---------------------------------------------------------
+
+unsigned MasterSynthesizer::xruns() const
+      {
+      unsigned n = _xruns;
+      for (const Synthesizer* s : _synthesizer)
+            n += s->xruns();
+      return n;
+      }
+
+//---------------------------------------------------------
+//   resetLoad
+//---------------------------------------------------------
+
+void MasterSynthesizer::resetLoad()
+      {
+      for (Synthesizer* s : _synthesizer)
+            s->load().reset();
+      for (LoadMeter& m : _effectLoad)
+            m.reset();
+      }
+
+//---------------------------------------------------------
+//   loadReport
+//    time spent in every synthesizer and effect slot
+//---------------------------------------------------------
+
+QString MasterSynthesizer::loadReport()
+      {
+      QString s;
+      for (Synthesizer* synth : _synthesizer)
+            s += synth->load().report(synth->name());
+      for (int ab = 0; ab < MAX_EFFECTS; ++ab) {
+            Effect* e = _effect[ab];
+            QString name = QString("effect %1 (%2)").arg(QChar('A' + ab)).arg(e ? e->name() : QString("none"));
+            s += _effectLoad[ab].report(name);
+            }
+      return s;
+      }
+
+//---------------------------------------------------------
+//   processEffect
+//---------------------------------------------------------
+
+void MasterSynthesizer::processEffect(int ab, Effect* e, unsigned n, float* in, float* out)
+      {
+      LoadMeter::Timer t(&_effectLoad[ab], n, _sampleRate);
+      e->process(n, in, out);
       }
 
 //---------------------------------------------------------
@@ -256,37 +308,34 @@ void MasterSynthesizer::setSampleRate(float val)
 
 void MasterSynthesizer::process(unsigned n, float* p)
       {
-      if (lock2)
+      if (!_ready)
             return;
-      lock1 = true;
-      if (lock2) {
-            lock1 = false;
-            return;
-            }
       // avoid overflow
-      if (n > MAX_BUFFERSIZE / 2)
+      if (n > MAX_BUFFERSIZE / 2) {
+            ++_xruns;
             return;
+            }
       for (Synthesizer* s : _synthesizer) {
-            if (s->active())
+            if (s->active()) {
+                  LoadMeter::Timer t(&s->load(), n, _sampleRate);
                   s->process(n, p, effect1Buffer, effect2Buffer);
+                  }
             }
 
-      if (_effect[0] && _effect[1]) {
+      Effect* e1 = _effect[0];
+      Effect* e2 = _effect[1];
+      if (e1 && e2) {
             memset(effect1Buffer, 0, n * sizeof(float) * 2);
-            _effect[0]->process(n, p, effect1Buffer);
-            _effect[1]->process(n, effect1Buffer, p);
+            processEffect(0, e1, n, p, effect1Buffer);
+            processEffect(1, e2, n, effect1Buffer, p);
             }
-      else if (_effect[0] || _effect[1]) {
+      else if (e1 || e2) {
             memcpy(effect1Buffer, p, n * sizeof(float) * 2);
-            if (_effect[0])
-                  _effect[0]->process(n, effect1Buffer, p);
-            else
-                  _effect[1]->process(n, effect1Buffer, p);
+            processEffect(e1 ? 0 : 1, e1 ? e1 : e2, n, effect1Buffer, p);
             }
       float g = _gain * _boost;
       for (unsigned i = 0; i < n * 2; ++i)
             *p++ *= g;
-      lock1 = false;
       }
 
 //---------------------------------------------------------
@@ -309,7 +358,7 @@ int MasterSynthesizer::indexOfEffect(int ab)
       {
       if (!_effect[ab])
             return 0;
-      return indexOfEffect(ab, _effect[ab]->name());
+      return indexOfEffect(ab, _effect[ab].load()->name());
       }
 
 //---------------------------------------------------------
@@ -370,17 +419,17 @@ SynthesizerState MasterSynthesizer::state() const
       SynthesizerState ss;
       SynthesizerGroup g;
       g.setName("master");
-      g.push_back(IdValue(0, QString("%1").arg(_effect[0] ? _effect[0]->name() : "NoEffect")));
-      g.push_back(IdValue(1, QString("%1").arg(_effect[1] ? _effect[1]->name() : "NoEffect")));
+      g.push_back(IdValue(0, QString("%1").arg(_effect[0] ? _effect[0].load()->name() : "NoEffect")));
+      g.push_back(IdValue(1, QString("%1").arg(_effect[1] ? _effect[1].load()->name() : "NoEffect")));
       g.push_back(IdValue(2, QString("%1").arg(gain())));
       g.push_back(IdValue(3, QString("%1").arg(masterTuning())));
       ss.push_back(g);
       for (Synthesizer* s : _synthesizer)
             ss.push_back(s->state());
       if (_effect[0])
-            ss.push_back(_effect[0]->state());
+            ss.push_back(_effect[0].load()->state());
       if (_effect[1])
-            ss.push_back(_effect[1]->state());
+            ss.push_back(_effect[1].load()->state());
       return ss;
       }
 
@@ -15,6 +15,7 @@
 
 #include <atomic>
 #include "effects/effect.h"
+#include "loadmeter.h"
 #include "libmscore/synthesizerstate.h"
 
 namespace Ms {
@@ -42,17 +43,19 @@ class MasterSynthesizer : public QObject {
       static const int MAX_EFFECTS = 2;
 
    private:
-      std::atomic<bool> lock1      { false };
-      std::atomic<bool> lock2      { true  };
+      std::atomic<bool> _ready     { false };     // set by setSampleRate()
+      std::atomic<unsigned> _xruns { 0 };         // blocks not processed
       std::vector<Synthesizer*> _synthesizer;
       std::vector<Effect*> _effectList[MAX_EFFECTS];
-      Effect* _effect[MAX_EFFECTS]  { nullptr, nullptr };
+      std::atomic<Effect*> _effect[MAX_EFFECTS]  { { nullptr }, { nullptr } };
+      LoadMeter _effectLoad[MAX_EFFECTS];          // time spent in the effect slots
 
       float _sampleRate;
 
       float effect1Buffer[MAX_BUFFERSIZE];
       float effect2Buffer[MAX_BUFFERSIZE];
       int indexOfEffect(int ab, const QString& name);
+      void processEffect(int ab, Effect*, unsigned n, float* in, float* out);
 
    public slots:
       void sfChanged() { emit soundFontChanged(); }
@@ -99,6 +102,11 @@ class MasterSynthesizer : public QObject {
       Effect* effect(int ab);
       int indexOfEffect(int ab);
 
+      unsigned xruns() const;
+      LoadMeter& effectLoad(int ab)    { return _effectLoad[ab]; }
+      void resetLoad();
+      QString loadReport();
+
       float gain() const     { return _gain; }
       float boost() const    { return _boost; }
       void setBoost(float v) { _boost = v; }
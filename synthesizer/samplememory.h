@@ -0,0 +1,74 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2015 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __SAMPLEMEMORY_H__
+#define __SAMPLEMEMORY_H__
+
+#include <atomic>
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   SampleMemory
+//    Sample data of the synthesizers is read into memory
+//    until the budget is used up. After that, only the
+//    first preload() ms of a sample are kept in memory;
+//    the rest is streamed by the SampleStreamer thread as
+//    voices play (see samplestream.h). A voice which gets
+//    ahead of its stream counts an underrun.
+//
+//    All state lives in function statics so that the
+//    synthesizer libraries can use this header without
+//    linking against each other.
+//---------------------------------------------------------
+
+class SampleMemory {
+      static std::atomic<qint64>& _loaded()   { static std::atomic<qint64> v { 0 }; return v; }
+      static std::atomic<qint64>& _streamed() { static std::atomic<qint64> v { 0 }; return v; }
+      static std::atomic<unsigned>& _underruns() { static std::atomic<unsigned> v { 0 }; return v; }
+
+   public:
+      static qint64& budget()    { static qint64 v = -1; return v; }     // bytes, -1: no limit
+      static int& preload()      { static int v = 500;   return v; }     // ms
+
+      static qint64 loaded()      { return _loaded();    }
+      static qint64 streamed()    { return _streamed();  }
+      static unsigned underruns() { return _underruns(); }
+
+      //---------------------------------------------------
+      //   fits
+      //    return true if bytes of sample data may still be
+      //    read into memory
+      //---------------------------------------------------
+
+      static bool fits(qint64 bytes)    { return budget() < 0 || _loaded() + bytes <= budget(); }
+      static void load(qint64 bytes)    { _loaded() += bytes; }
+      static void unload(qint64 bytes)  { _loaded() -= bytes; }
+      static void stream(qint64 bytes)  { _streamed() += bytes; }
+      static void unstream(qint64 bytes) { _streamed() -= bytes; }
+      static void underrun()            { ++_underruns(); }
+
+      //---------------------------------------------------
+      //   prefetch
+      //    page in mapped sample data
+      //---------------------------------------------------
+
+      static void prefetch(const void* p, qint64 bytes) {
+            const volatile char* c = static_cast<const volatile char*>(p);
+            for (qint64 i = 0; i < bytes; i += 4096)
+                  (void)c[i];
+            }
+      };
+
+}
+#endif
+
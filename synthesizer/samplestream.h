@@ -0,0 +1,315 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2015 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __SAMPLESTREAM_H__
+#define __SAMPLESTREAM_H__
+
+#include <atomic>
+#include <string.h>
+#include "samplememory.h"
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   StreamSource
+//    sample data which is not kept in memory: 16 bit
+//    frames in a file or in mapped memory
+//---------------------------------------------------------
+
+struct StreamSource {
+      QString path;                 // file, if data is not set
+      qint64 offset      { 0 };     // of the first frame in the file, in bytes
+      const short* data  { 0 };     // mapped frames
+      int channels       { 1 };
+      qint64 frames      { 0 };
+      };
+
+//---------------------------------------------------------
+//   SampleStream
+//    Feeds one voice from a StreamSource. Frames of a file
+//    are read into a ring buffer, mapped frames are paged
+//    in ahead of the voice.
+//
+//    The audio thread acquires an idle stream, starts and
+//    stops it; all file access is done by the
+//    SampleStreamer thread. Frames in front of available()
+//    may be used until the voice reports them consumed.
+//    A voice which starts to consume behind the streamed
+//    frames, e.g. at a sample offset beyond the ring,
+//    moves the stream to its position.
+//---------------------------------------------------------
+
+class SampleStream {
+   public:
+      static const int RING  = 16384;     // frames, power of two
+      static const int CHUNK = 2048;      // frames read at once
+      static const int GUARD = 3;         // frames mirrored after the ring end
+
+   private:
+      enum State { IDLE, OWNED, START, RUN, STOP };
+
+      std::atomic<int> _state  { IDLE };
+      std::atomic<const StreamSource*> _source { 0 };
+      std::atomic<qint64> _end { 0 };     // frames before _end are available
+      std::atomic<qint64> _pos { 0 };     // frames before _pos are not used anymore
+      short* _ring;                       // one frame, RING frames, GUARD frames
+
+      // streamer thread only
+      QFile _file;
+      short _chunk[CHUNK * 2];
+
+      //---------------------------------------------------
+      //   slot
+      //    ring position of frame f
+      //---------------------------------------------------
+
+      short* slot(qint64 f, int channels) const {
+            return _ring + (1 + (f & (RING - 1))) * channels;
+            }
+
+      //---------------------------------------------------
+      //   read
+      //    read n frames starting at frame f into the ring;
+      //    frames after the end of the sample are zero
+      //---------------------------------------------------
+
+      void read(const StreamSource* src, qint64 f, int n) {
+            int ch     = src->channels;
+            int frames = int(qBound(qint64(0), src->frames - f, qint64(n)));
+            int got    = 0;
+            if (frames && _file.isOpen() && _file.seek(src->offset + f * ch * sizeof(short)))
+                  got = qMax(qint64(0), _file.read(reinterpret_cast<char*>(_chunk), frames * ch * sizeof(short))) / (ch * sizeof(short));
+            memset(_chunk + got * ch, 0, (n - got) * ch * sizeof(short));
+
+            for (int i = 0; i < n; ++i) {
+                  qint64 k = (f + i) & (RING - 1);
+                  const short* s = _chunk + i * ch;
+                  memcpy(slot(f + i, ch), s, ch * sizeof(short));
+                  if (k < GUARD)
+                        memcpy(_ring + (1 + RING + k) * ch, s, ch * sizeof(short));
+                  else if (k == RING - 1)
+                        memcpy(_ring, s, ch * sizeof(short));
+                  }
+            }
+
+      //---------------------------------------------------
+      //   fill
+      //---------------------------------------------------
+
+      void fill(const StreamSource* src) {
+            qint64 pos   = _pos.load(std::memory_order_acquire);
+            qint64 end   = qMax(_end.load(std::memory_order_relaxed), pos);
+            qint64 limit = qMin(pos + RING, last(src));
+            while (end < limit && _state.load(std::memory_order_relaxed) == RUN) {
+                  int n = int(qMin(limit - end, qint64(CHUNK)));
+                  if (src->data)
+                        SampleMemory::prefetch(src->data + end * src->channels, n * src->channels * sizeof(short));
+                  else
+                        read(src, end, n);
+                  end += n;
+                  _end.store(end, std::memory_order_release);
+                  }
+            }
+
+      //---------------------------------------------------
+      //   last
+      //    frames of src which can be streamed
+      //---------------------------------------------------
+
+      static qint64 last(const StreamSource* src) {
+            return src->data ? src->frames : src->frames + GUARD;
+            }
+
+      void wake() const;
+
+   public:
+      SampleStream()  { _ring = new short[(1 + RING + GUARD) * 2]; }
+      ~SampleStream() { delete[] _ring; }
+
+      //---------------------------------------------------
+      //   audio thread interface
+      //---------------------------------------------------
+
+      bool acquire() {
+            int s = IDLE;
+            return _state.compare_exchange_strong(s, OWNED);
+            }
+
+      // stream src from frame on; frames up to resident
+      // are already in memory (mapped sources only)
+
+      void start(const StreamSource* src, qint64 frame, qint64 resident = 0) {
+            _source.store(src, std::memory_order_relaxed);
+            _pos.store(frame, std::memory_order_relaxed);
+            _end.store(src->data ? qMax(frame, qMin(resident, src->frames)) : frame, std::memory_order_relaxed);
+            _state.store(START, std::memory_order_release);
+            wake();
+            }
+      void stop() {
+            _state.store(STOP, std::memory_order_release);
+            wake();
+            }
+
+      qint64 available() const            { return _end.load(std::memory_order_acquire); }
+
+      // frames before frame are not used anymore; the
+      // streamer is woken up if a chunk can be read
+
+      void consumed(qint64 frame) {
+            _pos.store(frame, std::memory_order_release);
+            const StreamSource* src = _source.load(std::memory_order_relaxed);
+            qint64 end = _end.load(std::memory_order_relaxed);
+            if (src && end < last(src) && frame + RING - end >= qMin(qint64(CHUNK), last(src) - end))
+                  wake();
+            }
+
+      // frame f of src, followed by GUARD frames
+      const short* frame(const StreamSource* src, qint64 f) const {
+            return src->data ? src->data + f * src->channels : slot(f, src->channels);
+            }
+      const StreamSource* source() const  { return _source.load(std::memory_order_acquire); }
+
+      //---------------------------------------------------
+      //   service
+      //    called by the streamer thread
+      //---------------------------------------------------
+
+      void service() {
+            int state = _state.load(std::memory_order_acquire);
+            const StreamSource* src = _source.load(std::memory_order_relaxed);
+            switch (state) {
+                  case START: {
+                        if (!src->data) {
+                              _file.setFileName(src->path);
+                              _file.open(QIODevice::ReadOnly);
+                              }
+                        int s = START;
+                        if (_state.compare_exchange_strong(s, RUN))
+                              fill(src);
+                        }
+                        break;
+                  case RUN:
+                        fill(src);
+                        break;
+                  case STOP:
+                        _file.close();
+                        _source.store(0, std::memory_order_release);
+                        _state.store(IDLE, std::memory_order_release);
+                        break;
+                  default:
+                        break;
+                  }
+            }
+      };
+
+//---------------------------------------------------------
+//   SampleStreamer
+//    the thread which refills all sample streams. It
+//    sleeps until a stream is started, stopped or has room
+//    for a chunk. The audio thread releases the semaphore
+//    at most once per round of the streamer.
+//---------------------------------------------------------
+
+class SampleStreamer : public QThread {
+      static const int STREAMS = 128;
+      SampleStream _streams[STREAMS];
+      QSemaphore _wakeup;
+      std::atomic<bool> _pending { false };
+
+      virtual void run() override {
+            for (;;) {
+                  _wakeup.acquire();
+                  _pending.exchange(false, std::memory_order_acq_rel);
+                  for (SampleStream& s : _streams)
+                        s.service();
+                  }
+            }
+
+      SampleStreamer() {}
+
+   public:
+      //---------------------------------------------------
+      //   instance
+      //    created and started by the first sample which
+      //    is streamed; never deleted
+      //---------------------------------------------------
+
+      static SampleStreamer* instance() {
+            static SampleStreamer* streamer = [] {
+                  SampleStreamer* s = new SampleStreamer;
+                  s->start(QThread::HighPriority);
+                  return s;
+                  }();
+            return streamer;
+            }
+
+      //---------------------------------------------------
+      //   acquire
+      //    an idle stream for a voice, 0 if all are in use;
+      //    lock free, called by the audio thread
+      //---------------------------------------------------
+
+      SampleStream* acquire() {
+            for (SampleStream& s : _streams) {
+                  if (s.acquire())
+                        return &s;
+                  }
+            return 0;
+            }
+
+      //---------------------------------------------------
+      //   wake
+      //    let the streamer service all streams
+      //---------------------------------------------------
+
+      void wake() {
+            if (!_pending.exchange(true, std::memory_order_acq_rel))
+                  _wakeup.release();
+            }
+
+      //---------------------------------------------------
+      //   detach
+      //    stop all streams of src and wait until the
+      //    streamer thread does not use it anymore; called
+      //    before the sample data of src is deleted. The
+      //    voices playing src must have been turned off,
+      //    a stream is reused as soon as it is idle.
+      //---------------------------------------------------
+
+      void detach(const StreamSource* src) {
+            for (;;) {
+                  bool busy = false;
+                  for (SampleStream& s : _streams) {
+                        if (s.source() == src) {
+                              s.stop();
+                              busy = true;
+                              }
+                        }
+                  if (!busy)
+                        return;
+                  msleep(1);
+                  }
+            }
+      };
+
+//---------------------------------------------------------
+//   wake
+//---------------------------------------------------------
+
+inline void SampleStream::wake() const
+      {
+      SampleStreamer::instance()->wake();
+      }
+
+}
+#endif
+
@@ -13,7 +13,9 @@
 #ifndef __SYNTHESIZER_H__
 #define __SYNTHESIZER_H__
 
+#include <atomic>
 #include "libmscore/synthesizerstate.h"
+#include "loadmeter.h"
 
 namespace Ms {
 
@@ -32,6 +34,8 @@ class Synthesizer {
    protected:
       float _sampleRate;
       SynthesizerGui* _gui;
+      std::atomic<unsigned> _xruns { 0 };   // blocks skipped by process()
+      LoadMeter _load;                      // time spent in process()
 
    public:
       Synthesizer() : _active(false) { _gui = 0; }
@@ -51,6 +55,8 @@ class Synthesizer {
       virtual QStringList soundFonts() const = 0;
 
       virtual void process(unsigned, float*, float*, float*) = 0;
+      unsigned xruns() const          { return _xruns; }
+      LoadMeter& load()               { return _load; }
       virtual void play(const PlayEvent&) = 0;
 
       virtual const QList<MidiPatch*>& getPatchInfo() const = 0;
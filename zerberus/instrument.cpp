@@ -11,6 +11,7 @@
 //=============================================================================
 
 #include <stdio.h>
+#include <string.h>
 #include <math.h>
 #include <QFile>
 #include <QFileInfo>
@@ -18,6 +19,7 @@
 
 #include "libmscore/xml.h"
 #include "audiofile/audiofile.h"
+#include "synthesizer/samplestream.h"
 #include "thirdparty/qzip/qzipreader_p.h"
 
 #include "instrument.h"
@@ -31,11 +33,105 @@ int ZInstrument::idx;
 //   Sample
 //---------------------------------------------------------
 
+Sample::Sample(Ms::StreamSource* src, short* val, int loaded, int sr)
+   : _channel(src->channels), _data(val), _frames(int(src->frames)), _sampleRate(sr),
+     _loaded(loaded), _source(src)
+      {
+      }
+
 Sample::~Sample()
       {
+      if (_source) {
+            Ms::SampleStreamer::instance()->detach(_source);
+            Ms::SampleMemory::unstream(qint64(_frames - _loaded) * _channel * sizeof(short));
+            delete _source;
+            }
+      Ms::SampleMemory::unload(qint64(_loaded + 3) * _channel * sizeof(short));
       delete[] _data;
       }
 
+//---------------------------------------------------------
+//   findWavData
+//    find the sample data of an uncompressed 16 bit wav
+//    file; return false for all other formats
+//---------------------------------------------------------
+
+static bool findWavData(QFile& f, int* channel, int* sr, qint64* offset, qint64* frames)
+      {
+      if (QSysInfo::ByteOrder != QSysInfo::LittleEndian)
+            return false;
+      char h[12];
+      if (f.read(h, 12) != 12 || memcmp(h, "RIFF", 4) || memcmp(h + 8, "WAVE", 4))
+            return false;
+      bool fmt = false;
+      for (;;) {
+            char c[8];
+            if (f.read(c, 8) != 8)
+                  return false;
+            quint32 size = qFromLittleEndian<quint32>(reinterpret_cast<const uchar*>(c + 4));
+            if (memcmp(c, "fmt ", 4) == 0) {
+                  uchar b[16];
+                  if (size < 16 || f.read(reinterpret_cast<char*>(b), 16) != 16)
+                        return false;
+                  if (qFromLittleEndian<quint16>(b) != 1                  // PCM
+                     || qFromLittleEndian<quint16>(b + 14) != 16)         // bits per sample
+                        return false;
+                  *channel = qFromLittleEndian<quint16>(b + 2);
+                  *sr      = qFromLittleEndian<quint32>(b + 4);
+                  fmt      = true;
+                  size    -= 16;
+                  }
+            else if (memcmp(c, "data", 4) == 0) {
+                  if (!fmt || *channel < 1 || *channel > 2)
+                        return false;
+                  *offset = f.pos();
+                  *frames = qMin(qint64(size), f.size() - *offset) / (*channel * sizeof(short));
+                  return true;
+                  }
+            if (!f.seek(f.pos() + size + (size & 1)))
+                  return false;
+            }
+      }
+
+//---------------------------------------------------------
+//   streamSample
+//    read only the first preload ms of an uncompressed wav
+//    file; the voices stream the rest
+//---------------------------------------------------------
+
+static Sample* streamSample(const QString& s)
+      {
+      QFile f(s);
+      int channel;
+      int sr;
+      qint64 offset;
+      qint64 frames;
+      if (!f.open(QIODevice::ReadOnly) || !findWavData(f, &channel, &sr, &offset, &frames))
+            return 0;
+      int loaded = qMax(Ms::SampleStream::GUARD + 1, Ms::SampleMemory::preload() * sr / 1000);
+      if (frames < qint64(loaded) + 2)
+            return 0;
+      // like a loaded sample, the head gets a zero frame before
+      // the data; the two frames after it are the next frames of
+      // the file, so interpolation over the head end is exact
+      short* data  = new short[(loaded + 3) * channel];
+      qint64 bytes = qint64(loaded + 2) * channel * sizeof(short);
+      if (!f.seek(offset) || f.read(reinterpret_cast<char*>(data + channel), bytes) != bytes) {
+            delete[] data;
+            return 0;
+            }
+      memset(data, 0, channel * sizeof(short));
+
+      Ms::StreamSource* src = new Ms::StreamSource;
+      src->path     = s;
+      src->offset   = offset;
+      src->channels = channel;
+      src->frames   = frames;
+      Ms::SampleMemory::load(qint64(loaded + 3) * channel * sizeof(short));
+      Ms::SampleMemory::stream((frames - loaded) * channel * sizeof(short));
+      return new Sample(src, data, loaded, sr);
+      }
+
 //---------------------------------------------------------
 //   readSample
 //---------------------------------------------------------
@@ -52,6 +148,11 @@ Sample* ZInstrument::readSample(const QString& s, MQZipReader* uz)
                   }
             }
       else {
+            if (!Ms::SampleMemory::fits(QFileInfo(s).size())) {
+                  Sample* sa = streamSample(s);
+                  if (sa)
+                        return sa;
+                  }
             QFile f(s);
             if (!f.open(QIODevice::ReadOnly)) {
                   printf("Sample::read: open <%s> failed\n", qPrintable(s));
@@ -72,6 +173,7 @@ Sample* ZInstrument::readSample(const QString& s, MQZipReader* uz)
 
       short* data = new short[(frames + 3) * channel];
       Sample* sa  = new Sample(channel, data, frames, sr);
+      Ms::SampleMemory::load(qint64(frames + 3) * channel * sizeof(short));
 
       if (frames != a.read(data + channel, frames)) {
             qDebug("Sample read failed: %s\n", a.error());
@@ -13,8 +13,15 @@
 #ifndef __SAMPLE_H__
 #define __SAMPLE_H__
 
+namespace Ms {
+struct StreamSource;
+}
+
 //---------------------------------------------------------
 //   Sample
+//    A streamed sample keeps only its first loaded()
+//    frames in memory; the voice reads the rest from
+//    source().
 //---------------------------------------------------------
 
 class Sample {
@@ -22,16 +29,21 @@ class Sample {
       short* _data;
       int _frames;
       int _sampleRate;
+      int _loaded;
+      Ms::StreamSource* _source { 0 };
 
    public:
       Sample(int ch, short* val, int f, int sr)
-         : _channel(ch), _data(val), _frames(f), _sampleRate(sr) {}
+         : _channel(ch), _data(val), _frames(f), _sampleRate(sr), _loaded(f) {}
+      Sample(Ms::StreamSource* src, short* val, int loaded, int sr);
       ~Sample();
       bool read(const QString&);
       int frames() const     { return _frames;          }
       short* data() const    { return _data + _channel; }
       int channel() const    { return _channel;         }
       int sampleRate() const { return _sampleRate;      }
+      int loaded() const     { return _loaded;          }
+      const Ms::StreamSource* source() const { return _source; }
       };
 
 #endif
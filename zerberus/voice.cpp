@@ -11,7 +11,9 @@
 //=============================================================================
 
 #include <stdio.h>
+#include <limits.h>
 
+#include "config.h"
 #include "voice.h"
 #include "instrument.h"
 #include "channel.h"
@@ -19,6 +21,12 @@
 #include "zone.h"
 #include "sample.h"
 #include "synthesizer/msynthesizer.h"
+#include "synthesizer/samplestream.h"
+
+#if defined(USE_SSE) && defined(__SSE2__)
+#include <emmintrin.h>
+#define ZERBERUS_SSE2
+#endif
 
 float Voice::interpCoeff[INTERP_MAX][4];
 float Envelope::egPow[EG_SIZE];
@@ -58,6 +66,19 @@ void Voice::stop(float time)
       stopEnv.setTime(time, _zerberus->sampleRate());
       }
 
+//---------------------------------------------------------
+//   off
+//---------------------------------------------------------
+
+void Voice::off()
+      {
+      _state = VoiceState::OFF;
+      if (_stream) {
+            _stream->stop();
+            _stream = 0;
+            }
+      }
+
 //---------------------------------------------------------
 //   init
 //---------------------------------------------------------
@@ -103,6 +124,25 @@ void Voice::start(Channel* c, int key, int v, const Zone* z)
       eidx      = s->frames() * audioChan;
       _loopMode = z->loopMode;
 
+      if (_stream)
+            _stream->stop();
+      zoneOffset = z->offset;
+      _source    = s->source();
+      _stream    = 0;
+      headEnd    = INT_MAX;
+      if (_source) {
+            // the stream starts with the last frame of the head, which
+            // is the frame before the first one played from the stream
+            headEnd = s->loaded() - zoneOffset;
+            _stream = Ms::SampleStreamer::instance()->acquire();
+            if (_stream)
+                  _stream->start(_source, qMax(s->loaded(), zoneOffset) - 1);
+            else {
+                  Ms::SampleMemory::underrun();
+                  eidx = qMin(eidx, qMax(headEnd, 0) * audioChan);
+                  }
+            }
+
       _offMode  = z->offMode;
       _offBy    = z->offBy;
 
@@ -208,8 +248,182 @@ void Voice::updateFilter(float _fres)
             }
       }
 
+//---------------------------------------------------------
+//   interpolate
+//    4-tap interpolation of mono samples d[-1] - d[2]
+//---------------------------------------------------------
+
+static inline float interpolate(const short* d, const float* c)
+      {
+#ifdef ZERBERUS_SSE2
+      __m128i s = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(d - 1));
+      s         = _mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16);
+      __m128 v  = _mm_mul_ps(_mm_cvtepi32_ps(s), _mm_loadu_ps(c));
+      v         = _mm_add_ps(v, _mm_movehl_ps(v, v));
+      v         = _mm_add_ss(v, _mm_shuffle_ps(v, v, 1));
+      return _mm_cvtss_f32(v);
+#else
+      return c[0] * d[-1] + c[1] * d[0] + c[2] * d[1] + c[3] * d[2];
+#endif
+      }
+
+//---------------------------------------------------------
+//   interpolate
+//    4-tap interpolation of interleaved stereo samples
+//    d[-2] - d[5]
+//---------------------------------------------------------
+
+static inline void interpolate(const short* d, const float* c, float* l, float* r)
+      {
+#ifdef ZERBERUS_SSE2
+      __m128i s  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(d - 2));
+      __m128 lo  = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16));     // l0 r0 l1 r1
+      __m128 hi  = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16));     // l2 r2 l3 r3
+      __m128 cc  = _mm_loadu_ps(c);
+      __m128 v   = _mm_add_ps(_mm_mul_ps(lo, _mm_unpacklo_ps(cc, cc)),
+                              _mm_mul_ps(hi, _mm_unpackhi_ps(cc, cc)));
+      v          = _mm_add_ps(v, _mm_movehl_ps(v, v));
+      *l         = _mm_cvtss_f32(v);
+      *r         = _mm_cvtss_f32(_mm_shuffle_ps(v, v, 1));
+#else
+      *l = c[0] * d[-2] + c[1] * d[0] + c[2] * d[2] + c[3] * d[4];
+      *r = c[0] * d[-1] + c[1] * d[1] + c[2] * d[3] + c[3] * d[5];
+#endif
+      }
+
+#ifdef ZERBERUS_SSE2
+//---------------------------------------------------------
+//   taps
+//    four mono samples d[0] - d[3] as float
+//---------------------------------------------------------
+
+static inline __m128 taps(const short* d)
+      {
+      __m128i s = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(d));
+      return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16));
+      }
+
+//---------------------------------------------------------
+//   interpolate4
+//    interpolate four frames of mono samples at once: the
+//    taps and coefficients of the frames are transposed,
+//    so every lane computes one frame
+//---------------------------------------------------------
+
+static inline __m128 interpolate4(const short* const* d, const float* const* c)
+      {
+      __m128 s0 = taps(d[0] - 1);
+      __m128 s1 = taps(d[1] - 1);
+      __m128 s2 = taps(d[2] - 1);
+      __m128 s3 = taps(d[3] - 1);
+      __m128 c0 = _mm_loadu_ps(c[0]);
+      __m128 c1 = _mm_loadu_ps(c[1]);
+      __m128 c2 = _mm_loadu_ps(c[2]);
+      __m128 c3 = _mm_loadu_ps(c[3]);
+      _MM_TRANSPOSE4_PS(s0, s1, s2, s3);
+      _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+      return _mm_add_ps(_mm_add_ps(_mm_mul_ps(s0, c0), _mm_mul_ps(s1, c1)),
+                        _mm_add_ps(_mm_mul_ps(s2, c2), _mm_mul_ps(s3, c3)));
+      }
+
+//---------------------------------------------------------
+//   interpolate4
+//    interpolate four frames of interleaved stereo
+//    samples at once; l and r get one frame per lane
+//---------------------------------------------------------
+
+static inline void interpolate4(const short* const* d, const float* const* c, __m128* l, __m128* r)
+      {
+      __m128 sl[4], sr[4], cc[4];
+      for (int i = 0; i < 4; ++i) {
+            __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(d[i] - 2));
+            __m128 lo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16));     // l0 r0 l1 r1
+            __m128 hi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16));     // l2 r2 l3 r3
+            sl[i] = _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0));
+            sr[i] = _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1));
+            cc[i] = _mm_loadu_ps(c[i]);
+            }
+      _MM_TRANSPOSE4_PS(sl[0], sl[1], sl[2], sl[3]);
+      _MM_TRANSPOSE4_PS(sr[0], sr[1], sr[2], sr[3]);
+      _MM_TRANSPOSE4_PS(cc[0], cc[1], cc[2], cc[3]);
+      *l = _mm_add_ps(_mm_add_ps(_mm_mul_ps(sl[0], cc[0]), _mm_mul_ps(sl[1], cc[1])),
+                      _mm_add_ps(_mm_mul_ps(sl[2], cc[2]), _mm_mul_ps(sl[3], cc[3])));
+      *r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(sr[0], cc[0]), _mm_mul_ps(sr[1], cc[1])),
+                      _mm_add_ps(_mm_mul_ps(sr[2], cc[2]), _mm_mul_ps(sr[3], cc[3])));
+      }
+#endif
+
+//---------------------------------------------------------
+//   frame
+//    frame fi of the zone, 0 if the stream has not read it
+//    yet; avail is the first frame not available
+//---------------------------------------------------------
+
+inline const short* Voice::frame(int fi, qint64 avail) const
+      {
+      if (fi < headEnd)
+            return data + fi * audioChan;
+      if (fi < avail)
+            return _stream->frame(_source, fi + zoneOffset);
+      return 0;
+      }
+
+//---------------------------------------------------------
+//   frames4
+//    sample data and interpolation coefficients of the
+//    next four frames; false if one of them is past the
+//    end of the sample or not streamed yet. next is the
+//    phase after the four frames.
+//---------------------------------------------------------
+
+inline bool Voice::frames4(qint64 avail, const short** d, const float** c, Phase* next) const
+      {
+      Phase ph = phase;
+      for (int i = 0; i < 4; ++i) {
+            int idx = ph.index();
+            if (idx * audioChan >= eidx)
+                  return false;
+            d[i] = frame(idx, avail);
+            if (!d[i])
+                  return false;
+            c[i] = interpCoeff[ph.fract()];
+            ph += phaseIncr;
+            }
+      *next = ph;
+      return true;
+      }
+
+//---------------------------------------------------------
+//   streamAvailable
+//    the first frame of the zone which cannot be
+//    interpolated from the stream yet
+//---------------------------------------------------------
+
+inline qint64 Voice::streamAvailable() const
+      {
+      return _stream ? _stream->available() - zoneOffset - 2 : 0;
+      }
+
+//---------------------------------------------------------
+//   streamConsumed
+//---------------------------------------------------------
+
+inline void Voice::streamConsumed()
+      {
+      int fi = phase.index();
+      if (_stream && fi > headEnd)
+            _stream->consumed(fi + zoneOffset - 1);
+      }
+
 //---------------------------------------------------------
 //   process
+//    The voice is rendered in blocks: the interpolated
+//    samples of a block are computed first, with SSE2 four
+//    frames at a time, then filter, envelope and pan are
+//    applied. The recursive filter prevents vectorizing
+//    the second loop.
+//    A streamed voice which gets ahead of its stream
+//    plays silence for the rest of the block.
 //---------------------------------------------------------
 
 void Voice::process(int frames, float* p)
@@ -232,110 +446,171 @@ void Voice::process(int frames, float* p)
             last_fres = _fres;
             }
 
+      static const int BLOCK = 64;
+      float buffer[BLOCK * 2];
+      const float panLeft  = _channel->panLeftGain();
+      const float panRight = _channel->panRightGain();
+      bool starved = false;
+
       if (audioChan == 1) {
-            while (frames--) {
-                  int idx = phase.index();
-                  if (idx >= eidx) {
-                        off();
-                        break;
-                        }
-                  const float* coeffs = interpCoeff[phase.fract()];
-                  float f;
-                  f =  (coeffs[0] * data[idx-1]
-                      + coeffs[1] * data[idx+0]
-                      + coeffs[2] * data[idx+1]
-                      + coeffs[3] * data[idx+2]) * gain
-                      - a1 * hist1l
-                      - a2 * hist2l;
-                  float v = b02 * (f + hist2l) + b1 * hist1l;
-                  hist2l  = hist1l;
-                  hist1l  = f;
-
-                  if (filter_coeff_incr_count) {
-                        --filter_coeff_incr_count;
-                        a1  += a1_incr;
-                        a2  += a2_incr;
-                        b02 += b02_incr;
-                        b1  += b1_incr;
+            while (frames > 0) {
+                  int n = frames < BLOCK ? frames : BLOCK;
+                  int k = 0;
+                  qint64 avail = streamAvailable();
+                  for (; k < n; ++k) {
+#ifdef ZERBERUS_SSE2
+                        const short* d4[4];
+                        const float* c4[4];
+                        Phase next;
+                        if (k + 4 <= n && frames4(avail, d4, c4, &next)) {
+                              _mm_storeu_ps(buffer + k, _mm_mul_ps(interpolate4(d4, c4), _mm_set1_ps(gain)));
+                              phase = next;
+                              k += 3;
+                              continue;
+                              }
+#endif
+                        int idx = phase.index();
+                        if (idx >= eidx)
+                              break;
+                        const short* d = frame(idx, avail);
+                        if (!d) {
+                              if (!starved)
+                                    Ms::SampleMemory::underrun();
+                              starved = true;
+                              for (; k < n; ++k)
+                                    buffer[k] = 0.0f;
+                              break;
+                              }
+                        buffer[k] = interpolate(d, interpCoeff[phase.fract()]) * gain;
+                        phase += phaseIncr;
                         }
+                  streamConsumed();
+                  for (int i = 0; i < k; ++i) {
+                        float f = buffer[i] - a1 * hist1l - a2 * hist2l;
+                        float v = b02 * (f + hist2l) + b1 * hist1l;
+                        hist2l  = hist1l;
+                        hist1l  = f;
+
+                        if (filter_coeff_incr_count) {
+                              --filter_coeff_incr_count;
+                              a1  += a1_incr;
+                              a2  += a2_incr;
+                              b02 += b02_incr;
+                              b1  += b1_incr;
+                              }
 
-                  if (_state == VoiceState::STOP) {
-                        if (stopEnv.step()) {
-                              off();
-                              break;
+                        if (_state == VoiceState::STOP) {
+                              if (stopEnv.step()) {
+                                    off();
+                                    return;
+                                    }
+                              v *= stopEnv.val;
                               }
-                        v *= stopEnv.val;
+                        *p++  += v * panLeft;
+                        *p++  += v * panRight;
+                        }
+                  if (k < n) {
+                        off();      // end of sample
+                        return;
                         }
-                  *p++  += v * _channel->panLeftGain();
-                  *p++  += v * _channel->panRightGain();
-                  phase += phaseIncr;
+                  frames -= n;
                   }
             }
       else {
             //
             // handle interleaved stereo samples
             //
-            while (frames--) {
-                  int idx = phase.index() * 2;
-                  if (idx >= eidx) {
-                        off();
-                        // printf("end of sample\n");
-                        break;
-                        }
-
-                  const float* coeffs = interpCoeff[phase.fract()];
-                  float f1, f2;
-
-                  f1 = (coeffs[0] * data[idx-2]
-                      + coeffs[1] * data[idx]
-                      + coeffs[2] * data[idx+2]
-                      + coeffs[3] * data[idx+4])
-                      * gain * _channel->panLeftGain();
-
-                  f2 = (coeffs[0] * data[idx-1]
-                      + coeffs[1] * data[idx+1]
-                      + coeffs[2] * data[idx+3]
-                      + coeffs[3] * data[idx+5])
-                      * gain * _channel->panRightGain();
-
-                  if (_state == VoiceState::ATTACK) {
-                        if (attackEnv.step())
-                              _state = VoiceState::PLAYING;
-                        else {
-                              f1 *= attackEnv.val;
-                              f2 *= attackEnv.val;
+            const float gainLeft  = gain * panLeft;
+            const float gainRight = gain * panRight;
+            while (frames > 0) {
+                  int n = frames < BLOCK ? frames : BLOCK;
+                  int k = 0;
+                  qint64 avail = streamAvailable();
+                  for (; k < n; ++k) {
+#ifdef ZERBERUS_SSE2
+                        const short* d4[4];
+                        const float* c4[4];
+                        Phase next;
+                        if (k + 4 <= n && frames4(avail, d4, c4, &next)) {
+                              __m128 l, r;
+                              interpolate4(d4, c4, &l, &r);
+                              l = _mm_mul_ps(l, _mm_set1_ps(gainLeft));
+                              r = _mm_mul_ps(r, _mm_set1_ps(gainRight));
+                              _mm_storeu_ps(buffer + k * 2, _mm_unpacklo_ps(l, r));
+                              _mm_storeu_ps(buffer + k * 2 + 4, _mm_unpackhi_ps(l, r));
+                              phase = next;
+                              k += 3;
+                              continue;
                               }
-                        }
-                  else if (_state == VoiceState::STOP) {
-                        if (stopEnv.step()) {
-                              off();
+#endif
+                        int idx = phase.index();
+                        if (idx * 2 >= eidx)
+                              break;
+                        const short* d = frame(idx, avail);
+                        if (!d) {
+                              if (!starved)
+                                    Ms::SampleMemory::underrun();
+                              starved = true;
+                              for (; k < n; ++k) {
+                                    buffer[k * 2]     = 0.0f;
+                                    buffer[k * 2 + 1] = 0.0f;
+                                    }
                               break;
                               }
-                        f1 *= stopEnv.val;
-                        f2 *= stopEnv.val;
+                        float l, r;
+                        interpolate(d, interpCoeff[phase.fract()], &l, &r);
+                        buffer[k * 2]     = l * gainLeft;
+                        buffer[k * 2 + 1] = r * gainRight;
+                        phase += phaseIncr;
                         }
+                  streamConsumed();
+                  for (int i = 0; i < k; ++i) {
+                        float f1 = buffer[i * 2];
+                        float f2 = buffer[i * 2 + 1];
+
+                        if (_state == VoiceState::ATTACK) {
+                              if (attackEnv.step())
+                                    _state = VoiceState::PLAYING;
+                              else {
+                                    f1 *= attackEnv.val;
+                                    f2 *= attackEnv.val;
+                                    }
+                              }
+                        else if (_state == VoiceState::STOP) {
+                              if (stopEnv.step()) {
+                                    off();
+                                    return;
+                                    }
+                              f1 *= stopEnv.val;
+                              f2 *= stopEnv.val;
+                              }
 
-                  f1      += -a1 * hist1l - a2 * hist2l;
-                  float vl = b02 * (f1 + hist2l) + b1 * hist1l;
-                  hist2l   = hist1l;
-                  hist1l   = f1;
-
-                  f2      +=  -a1 * hist1r - a2 * hist2r;
-                  float vr = b02 * (f2 + hist2r) + b1 * hist1r;
-                  hist2r   = hist1r;
-                  hist1r   = f2;
-
-                  if (filter_coeff_incr_count) {
-                        --filter_coeff_incr_count;
-                        a1  += a1_incr;
-                        a2  += a2_incr;
-                        b02 += b02_incr;
-                        b1  += b1_incr;
-                        }
+                        f1      += -a1 * hist1l - a2 * hist2l;
+                        float vl = b02 * (f1 + hist2l) + b1 * hist1l;
+                        hist2l   = hist1l;
+                        hist1l   = f1;
+
+                        f2      +=  -a1 * hist1r - a2 * hist2r;
+                        float vr = b02 * (f2 + hist2r) + b1 * hist1r;
+                        hist2r   = hist1r;
+                        hist1r   = f2;
+
+                        if (filter_coeff_incr_count) {
+                              --filter_coeff_incr_count;
+                              a1  += a1_incr;
+                              a2  += a2_incr;
+                              b02 += b02_incr;
+                              b1  += b1_incr;
+                              }
 
-                  *p++  += vl;
-                  *p++  += vr;
-                  phase += phaseIncr;
+                        *p++  += vl;
+                        *p++  += vr;
+                        }
+                  if (k < n) {
+                        off();      // end of sample
+                        return;
+                        }
+                  frames -= n;
                   }
             }
       }
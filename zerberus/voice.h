@@ -16,6 +16,11 @@
 #include <cstdint>
 #include <math.h>
 
+namespace Ms {
+class SampleStream;
+struct StreamSource;
+}
+
 class Channel;
 struct Zone;
 class Sample;
@@ -104,6 +109,13 @@ class Voice {
 
       short* data;
       int eidx;
+
+      // frames from headEnd on are read from _stream, if the
+      // sample is streamed
+      int headEnd;
+      int zoneOffset;
+      const Ms::StreamSource* _source;
+      Ms::SampleStream* _stream { 0 };
       LoopMode _loopMode;
       OffMode _offMode;
       int _offBy;
@@ -147,6 +159,10 @@ class Voice {
       static float interpCoeff[INTERP_MAX][4];
 
       void updateFilter(float fres);
+      const short* frame(int fi, qint64 avail) const;
+      bool frames4(qint64 avail, const short** d, const float** c, Phase* next) const;
+      qint64 streamAvailable() const;
+      void streamConsumed();
 
    public:
       Voice(Zerberus*);
@@ -167,7 +183,7 @@ class Voice {
       void stop()                 { _state = VoiceState::STOP;      }
       void stop(float time);
       void sustained()            { _state = VoiceState::SUSTAINED; }
-      void off()                  { _state = VoiceState::OFF;       }
+      void off();
       const char* state() const;
       LoopMode loopMode() const   { return _loopMode; }
 
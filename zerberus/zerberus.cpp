@@ -61,6 +61,7 @@ Zerberus::Zerberus()
 Zerberus::~Zerberus()
       {
       busy = true;
+      voicesOff();
       while (!instruments.empty()) {
             auto i  = instruments.front();
             auto it = instruments.begin();
@@ -280,6 +281,19 @@ void Zerberus::allNotesOff(int channel)
       busy = false;
       }
 
+//---------------------------------------------------------
+//   voicesOff
+//    turn off all voices and give back their sample
+//    streams; called with busy set before samples are
+//    deleted
+//---------------------------------------------------------
+
+void Zerberus::voicesOff()
+      {
+      for (Voice* v = activeVoices; v; v = v->next())
+            v->off();
+      }
+
 //---------------------------------------------------------
 //   loadSoundFonts
 //---------------------------------------------------------
@@ -342,7 +356,10 @@ bool Zerberus::removeSoundFont(const QString& s)
                         if (it == globalInstruments.end())
                               return false;
                         globalInstruments.erase(it);
+                        busy = true;
+                        voicesOff();
                         delete i;
+                        busy = false;
                         }
                   return true;
                   }
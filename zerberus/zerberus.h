@@ -83,6 +83,7 @@ class Zerberus : public Ms::Synthesizer {
       void trigger(Channel*, int key, int velo, Trigger);
       void processNoteOff(Channel*, int pitch);
       void processNoteOn(Channel* cp, int key, int velo);
+      void voicesOff();
 
    public:
       Zerberus();